@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    Derived, per block parameters handed to the DSP kernels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+// Small helpers the kernels call are always inlined: the kernels are compiled once per
+// instruction set (see FROGGKernels.h), and an out of line copy built for a wider one
+// could otherwise be linked into the code of a narrower one.
+#if defined (_MSC_VER)
+ #define FROGG_FORCE_INLINE __forceinline
+#else
+ #define FROGG_FORCE_INLINE inline __attribute__ ((always_inline))
+#endif
+
+//==============================================================================
+// Modulated delay range of each effect type, in seconds:
+struct FROGGDelayRange
+{
+    float minSeconds;
+    float maxSeconds;
+};
+
+static constexpr FROGGDelayRange FROGGChorusRange  { 0.005f, 0.03f };
+static constexpr FROGGDelayRange FROGGFlangerRange { 0.001f, 0.005f };
+
+// Widest channel set processed by one instance (9.1.6), a multiple of every register width:
+static constexpr int FROGGMaxChannels = 16;
+
+// Most read heads (ensemble voices) sharing one write head:
+static constexpr int FROGGMaxVoices = 8;
+
+// Highest oversampling factor the delay memory is sized for:
+static constexpr int FROGGMaxOversamplingFactor = 4;
+
+// Samples processed per pass of the LFO and delay kernels, keeps their scratch memory in L1:
+static constexpr int FROGGChunkSize = 256;
+
+// Longest delay any type can reach, what the delay memory is sized for:
+static constexpr float FROGGMaxDelaySeconds = FROGGChorusRange.maxSeconds;
+
+//==============================================================================
+// Fractional delay interpolators the read heads can use:
+enum class FROGGInterpolation
+{
+    linear,     // 2 points
+    hermite,    // 4-point cubic Hermite
+    lagrange,   // 6-point Lagrange
+    sinc        // 8-point Kaiser windowed sinc
+};
+
+//==============================================================================
+// Linear ramp over a block, value i is start + step * i:
+struct FROGGRamp
+{
+    float start = 0.0f;
+    float step = 0.0f;
+
+    FROGG_FORCE_INLINE float at (int i) const { return start + step * (float) i; }
+    FROGG_FORCE_INLINE bool isConstant() const { return step == 0.0f; }
+};
+
+//==============================================================================
+/**
+    Everything the kernels need for one block, already converted to samples and
+    smoothed, so the inner loop never touches a parameter or the sample rate.
+*/
+struct FROGGBlockParameters
+{
+    FROGGRamp phaseIncrement;   // LFO cycles per sample
+    FROGGRamp phaseOffset;      // LFO offset of the last channel in cycles, spread evenly over the others
+    FROGGRamp delayCentre;      // Centre of the modulated delay, in samples
+    FROGGRamp delayDepth;       // LFO excursion around the centre, in samples
+    FROGGRamp feedback;         // Gain of the delayed signal sent back to the input
+    FROGGRamp dryWet;           // 0 is fully dry, 1 fully wet
+    int numVoices = 1;          // Read heads per channel, 1..FROGGMaxVoices
+    int controlInterval = 1;    // Samples between two evaluations of the LFO
+    FROGGInterpolation interpolation = FROGGInterpolation::linear;
+
+    // The same parameters for a signal running rateFactor times as fast (oversampled, or below 1 when reduced):
+    // delays and intervals in samples grow by the factor, increments and ramp steps per sample shrink.
+    FROGGBlockParameters withRateFactor (float rateFactor) const
+    {
+        auto scaled = [rateFactor] (FROGGRamp ramp, float valueScale)
+        {
+            return FROGGRamp { ramp.start * valueScale, ramp.step * valueScale / rateFactor };
+        };
+
+        FROGGBlockParameters result = *this;
+        result.phaseIncrement = scaled(phaseIncrement, 1.0f / rateFactor);
+        result.phaseOffset = scaled(phaseOffset, 1.0f);
+        result.delayCentre = scaled(delayCentre, rateFactor);
+        result.delayDepth = scaled(delayDepth, rateFactor);
+        result.feedback = scaled(feedback, 1.0f);
+        result.dryWet = scaled(dryWet, 1.0f);
+        const int interval = (int) ((float) controlInterval * rateFactor);
+        result.controlInterval = interval > 1 ? interval : 1;
+        return result;
+    }
+};
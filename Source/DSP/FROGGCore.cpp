@@ -0,0 +1,753 @@
+/*
+  ==============================================================================
+
+    The chorus / flanger without JUCE: smoothing, LFO, modulated delay and
+    mix on buffers the caller owns.
+
+  ==============================================================================
+*/
+
+#include "FROGGCore.h"
+#include "FROGGInterpolators.h"
+#include "FROGGTrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+//==============================================================================
+namespace
+{
+    // Tier of a quality index, out of range ones clamped:
+    const FROGGQualityTier& getQualityTier (int quality)
+    {
+        return FROGGQualityTiers[std::clamp(quality, 0, FROGGNumQualityTiers - 1)];
+    }
+
+    // Oversampling factor of the parameters, 1, 2 or 4:
+    int getOversamplingFactor (const FROGGCore::Parameters& parameters)
+    {
+        return parameters.oversamplingFactor >= 4 ? 4 : parameters.oversamplingFactor >= 2 ? 2 : 1;
+    }
+
+    // Remainder of a sample position divided by divisor, also before a timeline's zero:
+    int getPositionRemainder (long long samplePosition, int divisor)
+    {
+        return (int) (((samplePosition % divisor) + divisor) % divisor);
+    }
+}
+
+//==============================================================================
+FROGGCore::FROGGCore()
+{
+    mDoublePrecisionCaller = false;
+    mDoubleEngineReady = false;
+    mUsingDoublePrecision = false;
+
+    mWetMuted = false;
+    mSwitchingPrecision = false;
+
+    mOversamplerFactory = nullptr;
+    mMonitor = nullptr;
+
+    // Nothing to process until prepare
+    mNumChannels = 0;
+    mMaxBlockSize = 0;
+
+    mOversamplingFactor = 1;
+    mRateReduction = 1;
+    mLatency = 0;
+    mLatencyChanged = false;
+    mReducedDryWet = 0.0f;
+
+    mNumSilentSamples = 0;
+    mIsIdle = false;
+
+    mSamplePosition = 0;
+    mTimelinePhase = 0.0;
+    mTimelinePosition = 0;
+}
+
+FROGGCore::~FROGGCore()
+{
+    // Delay memory goes back to the shared pool for the next instance:
+    release();
+}
+
+//==============================================================================
+void FROGGCore::prepare (double sampleRate, int numChannels, int maxBlockSize, bool doublePrecision, const Parameters& parameters)
+{
+    mParameters = parameters;
+    mNumChannels = std::clamp(numChannels, 1, FROGGMaxChannels);
+    mMaxBlockSize = std::max(1, maxBlockSize);
+    mDoublePrecisionCaller = doublePrecision;
+
+    // Smoothers start at the parameter values, the LFO at phase 0 running free, the sample count at 0:
+    mParameterStage.prepare(sampleRate, parameters);
+    mLFO.reset();
+    mLFO.setNumChannels(mNumChannels);
+    mSamplePosition = 0;
+
+    // LFO values are rendered one chunk at a time, for every voice of every channel:
+    mLFOMemory.assign((size_t) (mNumChannels * FROGGMaxVoices * FROGGChunkSize), 0.0f);
+    mLFOChannels.resize((size_t) (mNumChannels * FROGGMaxVoices));
+
+    for (size_t i = 0; i < mLFOChannels.size(); i++) {
+        mLFOChannels[i] = mLFOMemory.data() + i * FROGGChunkSize;
+    }
+
+    // Build the interpolation tables here rather than on the audio thread:
+    for (auto interpolation : { FROGGInterpolation::hermite, FROGGInterpolation::lagrange, FROGGInterpolation::sinc }) {
+        FROGGInterpolationTable::get(interpolation);
+    }
+
+    // Silence is counted again from the start:
+    mNumSilentSamples = 0;
+    mIsIdle = false;
+
+    // The smoothers start unmuted:
+    mWetMuted = false;
+    mSwitchingPrecision = false;
+
+    // Only the engine of the caller's precision holds memory. The part of its delay line the
+    // processing rate needs is used, which also resets the feedback:
+    const int reduction = parameters.rateReduction ? FROGGGetRateReduction(sampleRate) : 1;
+    const int factor = reduction > 1 || mOversamplerFactory == nullptr ? 1 : getOversamplingFactor(parameters);
+
+    mDoubleEngineReady = false;
+    mUsingDoublePrecision = false;
+    mPrecisionBuffer.clear();
+
+    if (doublePrecision) {
+        mFloatEngine.release();
+        mDoubleEngine.prepare(sampleRate, mNumChannels, mMaxBlockSize, mOversamplerFactory);
+        setProcessingRate<double>(factor, reduction);
+    }
+    else {
+        mDoubleEngine.release();
+        mFloatEngine.prepare(sampleRate, mNumChannels, mMaxBlockSize, mOversamplerFactory);
+        setProcessingRate<float>(factor, reduction);
+    }
+
+    // A float caller on a double precision tier gets the double engine as well and starts on it,
+    // there is nothing to fade yet. A later switch to such a tier waits for prepareDoubleEngine:
+    if (needsDoubleEngine()) {
+        prepareDoubleEngine();
+        mUsingDoublePrecision = true;
+        setProcessingRate<double>(factor, reduction);
+    }
+
+    // The caller reads the latency after prepare:
+    mLatencyChanged = false;
+}
+
+void FROGGCore::release()
+{
+    mNumChannels = 0;
+    mDoubleEngineReady = false;
+    mUsingDoublePrecision = false;
+
+    mFloatEngine.release();
+    mDoubleEngine.release();
+
+    mLFOMemory.clear();
+    mLFOMemory.shrink_to_fit();
+    mLFOChannels.clear();
+    mPrecisionBuffer.clear();
+    mPrecisionBuffer.shrink_to_fit();
+    mLatency = 0;
+    mLatencyChanged = false;
+}
+
+void FROGGCore::reset()
+{
+    if (! isPrepared())
+        return;
+
+    mParameterStage.prepare(getSampleRate(), mParameters);
+    mLFO.reset();
+    mSamplePosition = 0;
+
+    mNumSilentSamples = 0;
+    mIsIdle = false;
+
+    mWetMuted = false;
+    mSwitchingPrecision = false;
+
+    if (mUsingDoublePrecision || mDoublePrecisionCaller) {
+        setProcessingRate<double>(mOversamplingFactor, mRateReduction);
+    }
+    else {
+        setProcessingRate<float>(mOversamplingFactor, mRateReduction);
+    }
+}
+
+bool FROGGCore::needsDoubleEngine() const
+{
+    return isPrepared() && ! mDoublePrecisionCaller && ! mDoubleEngineReady && getQualityTier(mParameters.quality).doublePrecision;
+}
+
+void FROGGCore::prepareDoubleEngine()
+{
+    if (! isPrepared() || mDoublePrecisionCaller || mDoubleEngineReady)
+        return;
+
+    mDoubleEngine.prepare(getSampleRate(), mNumChannels, mMaxBlockSize, mOversamplerFactory);
+    mPrecisionBuffer.assign((size_t) (mNumChannels * mMaxBlockSize), 0.0);
+    mDoubleEngineReady = true;
+}
+
+void FROGGCore::setParameters (const Parameters& parameters)
+{
+    // On a timeline a new rate carries on from the phase the old one reached:
+    const bool isNewTimelineRate = mLFO.isOnTimeline() && parameters.rate != mParameters.rate;
+
+    if (isNewTimelineRate) {
+        const double phase = mTimelinePhase + (double) (mSamplePosition - mTimelinePosition) * mParameters.rate / getSampleRate();
+        mTimelinePhase = phase - std::floor(phase);
+        mTimelinePosition = mSamplePosition;
+    }
+
+    mParameters = parameters;
+    mParameterStage.update(parameters);
+
+    if (isNewTimelineRate) {
+        updateLFOTimeline();
+    }
+}
+
+void FROGGCore::syncLFOToTimeline (double phase, long long samplePosition)
+{
+    if (! isPrepared())
+        return;
+
+    // The rate reduction groups start on multiples of the reduction, a jump by anything else
+    // starts the group the new position falls in over:
+    const bool isRegrouped = getPositionRemainder(samplePosition - mSamplePosition, mRateReduction) != 0;
+
+    mSamplePosition = samplePosition;
+    mTimelinePhase = phase - std::floor(phase);
+    mTimelinePosition = samplePosition;
+
+    if (isRegrouped) {
+        regroupRateReducer();
+    }
+
+    updateLFOTimeline();
+}
+
+void FROGGCore::wakeUp()
+{
+    mNumSilentSamples = 0;
+
+    if (! mIsIdle)
+        return;
+
+    mIsIdle = false;
+
+    // The idle path moved the sample count on without the rate reducer or the LFO samples:
+    regroupRateReducer();
+
+    if (mLFO.isOnTimeline()) {
+        updateLFOTimeline();
+    }
+}
+
+void FROGGCore::regroupRateReducer()
+{
+    if (mRateReduction == 1)
+        return;
+
+    const int groupPosition = getPositionRemainder(mSamplePosition, mRateReduction);
+
+    if (mUsingDoublePrecision || mDoublePrecisionCaller) {
+        mDoubleEngine.rateReducer.reset(groupPosition);
+    }
+    else {
+        mFloatEngine.rateReducer.reset(groupPosition);
+    }
+}
+
+void FROGGCore::updateLFOTimeline()
+{
+    // LFO sample n sits at host sample n * reduction / factor: each oversampled one, or the first
+    // of each rate reduction group. The next one to process is that of the group in progress:
+    const long long scaledPosition = mSamplePosition * mOversamplingFactor;
+    const long long lfoPosition = (scaledPosition - getPositionRemainder(scaledPosition, mRateReduction)) / mRateReduction;
+
+    const double cyclesPerSample = (double) mParameters.rate / getSampleRate();
+    const double hostPosition = (double) lfoPosition * mRateReduction / mOversamplingFactor;
+    const double phase = mTimelinePhase + (hostPosition - (double) mTimelinePosition) * cyclesPerSample;
+
+    mLFO.setTimeline(phase, lfoPosition, cyclesPerSample * mRateReduction / mOversamplingFactor);
+}
+
+void FROGGCore::setWetMuted (bool shouldBeMuted)
+{
+    mWetMuted = shouldBeMuted;
+
+    // A precision switch keeps the wet signal down until it is done:
+    mParameterStage.setWetMuted(mWetMuted || mSwitchingPrecision);
+}
+
+//==============================================================================
+template <typename SampleType>
+void FROGGCore::Engine<SampleType>::prepare (double sampleRate, int numChannels, int maxBlockSize, FROGGOversamplerFactory* oversamplerFactory)
+{
+    // Up / down samplers for every factor, so switching never allocates on the audio thread:
+    for (int i = 0; i < 2; i++) {
+        if (oversamplerFactory == nullptr) {
+            oversamplers[i].reset();
+        }
+        else if constexpr (std::is_same_v<SampleType, double>) {
+            oversamplers[i] = oversamplerFactory->createDouble(2 << i, numChannels, maxBlockSize);
+        }
+        else {
+            oversamplers[i] = oversamplerFactory->createFloat(2 << i, numChannels, maxBlockSize);
+        }
+    }
+
+    // Rate reduction by the power of two this rate allows, none at 44.1 / 48 kHz:
+    rateReducer.prepare(sampleRate, numChannels, maxBlockSize, FROGGGetRateReduction(sampleRate));
+
+    // Kernels of the instruction set chosen for this CPU, on the register width that suits the bus:
+    kernels = &FROGGGetKernels();
+    registerSize = kernels->getRegisterSize<SampleType>(numChannels);
+
+    // Circular buffer sized to the longest modulated delay at the highest oversampling factor plus
+    // the taps the interpolators read behind it, rounded up to a power of two. Channels are grouped
+    // by register width in each frame, padded to a whole register. The guard frames hold the points
+    // read past the end:
+    const int numLanes = (numChannels + registerSize - 1) / registerSize * registerSize;
+    const float maxDelaySamples = (float) (sampleRate * FROGGMaxOversamplingFactor * FROGGMaxDelaySeconds) + FROGGMaxInterpolationTapsBehind;
+    delayLine.prepare(maxDelaySamples, numLanes, FROGGMaxInterpolationTaps - 1);
+}
+
+template <typename SampleType>
+void FROGGCore::Engine<SampleType>::release()
+{
+    delayLine.release();
+
+    for (auto& oversampler : oversamplers) {
+        oversampler.reset();
+    }
+
+    rateReducer.release();
+}
+
+template <typename SampleType>
+FROGGCore::Engine<SampleType>& FROGGCore::getEngine()
+{
+    if constexpr (std::is_same_v<SampleType, double>) {
+        return mDoubleEngine;
+    }
+    else {
+        return mFloatEngine;
+    }
+}
+
+//==============================================================================
+void FROGGCore::process (float* const* channels, int numChannels, int numSamples)
+{
+    processChannels(channels, 1, numChannels, numSamples);
+}
+
+void FROGGCore::process (double* const* channels, int numChannels, int numSamples)
+{
+    processChannels(channels, 1, numChannels, numSamples);
+}
+
+void FROGGCore::processInterleaved (float* frames, int numChannels, int numFrames)
+{
+    // Every channel starts at its offset in the first frame, a frame apart from one sample to the next:
+    float* channels[FROGGMaxChannels];
+
+    for (int channel = 0; channel < std::min(numChannels, FROGGMaxChannels); channel++) {
+        channels[channel] = frames + channel;
+    }
+
+    processChannels(channels, numChannels, numChannels, numFrames);
+}
+
+void FROGGCore::processInterleaved (double* frames, int numChannels, int numFrames)
+{
+    double* channels[FROGGMaxChannels];
+
+    for (int channel = 0; channel < std::min(numChannels, FROGGMaxChannels); channel++) {
+        channels[channel] = frames + channel;
+    }
+
+    processChannels(channels, numChannels, numChannels, numFrames);
+}
+
+template <typename SampleType>
+void FROGGCore::processChannels (SampleType* const* channels, int sampleStride, int numChannels, int numSamples)
+{
+    if (! isPrepared() || numSamples <= 0)
+        return;
+
+    // Only the engine of the precision prepared for holds memory, other buffers pass through:
+    if (std::is_same_v<SampleType, double> != mDoublePrecisionCaller)
+        return;
+
+    FROGG_TRACE_ZONE("FROGGCore::process");
+
+    // Channels past the prepared ones pass through:
+    numChannels = std::min(numChannels, mNumChannels);
+
+    // A float caller runs the double engine for the tiers that ask for it:
+    if constexpr (std::is_same_v<SampleType, float>) {
+        updatePrecision();
+    }
+
+    // Any input above the threshold wakes the processing up:
+    if (getPeakLevel(channels, sampleStride, numChannels, numSamples) > silenceThreshold) {
+        wakeUp();
+    }
+    else {
+        mNumSilentSamples += numSamples;
+
+        if (! mIsIdle && mNumSilentSamples > (long long) (computeTailSeconds(mParameters.feedback, mParameters.type) * getSampleRate())) {
+            if (mUsingDoublePrecision) {
+                enterIdle<double>();
+            }
+            else {
+                enterIdle<SampleType>();
+            }
+        }
+    }
+
+    // Idle: the silent input passes through, only the smoothers and the LFO phase move on,
+    // so the modulation picks up where it would have been:
+    if (mIsIdle) {
+        const FROGGBlockParameters ramps = mParameterStage.getNextRamps(numSamples);
+        mLFO.advance(numSamples, ramps.phaseIncrement);
+    }
+    else if (mUsingDoublePrecision && ! std::is_same_v<SampleType, double>) {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            processInDouble(channels, sampleStride, numChannels, numSamples);
+        }
+    }
+    else {
+        processSegment(channels, sampleStride, numChannels, numSamples);
+    }
+
+    mSamplePosition += numSamples;
+}
+
+void FROGGCore::processInDouble (float* const* channels, int sampleStride, int numChannels, int numSamples)
+{
+    double* converted[FROGGMaxChannels];
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        converted[channel] = mPrecisionBuffer.data() + channel * mMaxBlockSize;
+    }
+
+    // Converted to planar doubles and back, at most as many samples at a time as the buffer holds:
+    for (int blockStart = 0; blockStart < numSamples; blockStart += mMaxBlockSize) {
+
+        const int blockSize = std::min(mMaxBlockSize, numSamples - blockStart);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            const float* input = channels[channel] + blockStart * sampleStride;
+
+            for (int i = 0; i < blockSize; i++) {
+                converted[channel][i] = (double) input[i * sampleStride];
+            }
+        }
+
+        processSegment(converted, 1, numChannels, blockSize);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            float* output = channels[channel] + blockStart * sampleStride;
+
+            for (int i = 0; i < blockSize; i++) {
+                output[i * sampleStride] = (float) converted[channel][i];
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void FROGGCore::processSegment (SampleType* const* channels, int sampleStride, int numChannels, int numSamples)
+{
+    Engine<SampleType>& engine = getEngine<SampleType>();
+    SampleType* block[FROGGMaxChannels];
+
+    // The rate reduction takes the place of the oversampling while it is on, which needs oversamplers:
+    const int reduction = mParameters.rateReduction ? engine.rateReducer.getFactor() : 1;
+    const int factor = reduction > 1 || engine.oversamplers[0] == nullptr ? 1 : getOversamplingFactor(mParameters);
+
+    if (factor != mOversamplingFactor || reduction != mRateReduction) {
+        setProcessingRate<SampleType>(factor, reduction);
+    }
+
+    if (reduction > 1) {
+        processReduced(channels, sampleStride, numChannels, numSamples);
+        return;
+    }
+
+    if (factor == 1) {
+        processDelay(channels, sampleStride, numChannels, numSamples, 1, 1);
+        return;
+    }
+
+    // Up sample, run the delay at the higher rate and down sample again, at most as many samples at
+    // a time as the oversampler was prepared for:
+    FROGGOversampler<SampleType>& oversampler = *engine.oversamplers[factor == 2 ? 0 : 1];
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += mMaxBlockSize) {
+
+        const int blockSize = std::min(mMaxBlockSize, numSamples - blockStart);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            block[channel] = channels[channel] + blockStart * sampleStride;
+        }
+
+        SampleType* const* oversampled;
+
+        {
+            FROGG_TRACE_ZONE("Oversampling up");
+            oversampled = oversampler.processUp(block, sampleStride, numChannels, blockSize);
+        }
+
+        processDelay(oversampled, 1, numChannels, blockSize * factor, factor, 1);
+
+        FROGG_TRACE_ZONE("Oversampling down");
+        oversampler.processDown(block, sampleStride, numChannels, blockSize);
+    }
+}
+
+template <typename SampleType>
+void FROGGCore::processReduced (SampleType* const* channels, int sampleStride, int numChannels, int numSamples)
+{
+    FROGGRateReducer<SampleType>& rateReducer = getEngine<SampleType>().rateReducer;
+    SampleType* block[FROGGMaxChannels];
+
+    // Down sample, run the delay at the reduced rate and up sample again, at most as many samples
+    // at a time as the reducer was prepared for:
+    for (int blockStart = 0; blockStart < numSamples; blockStart += mMaxBlockSize) {
+
+        const int blockSize = std::min(mMaxBlockSize, numSamples - blockStart);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            block[channel] = channels[channel] + blockStart * sampleStride;
+        }
+
+        int numReduced;
+
+        {
+            FROGG_TRACE_ZONE("Rate reduction down");
+            numReduced = rateReducer.decimate(block, sampleStride, numChannels, blockSize);
+        }
+
+        // Fully wet at the reduced rate, the dry / wet value it reached is mixed in below:
+        const float startDryWet = mReducedDryWet;
+        processDelay(rateReducer.getReducedChannels(), 1, numChannels, numReduced, 1, mRateReduction);
+
+        FROGG_TRACE_ZONE("Rate reduction up");
+        rateReducer.interpolate(numChannels, numReduced);
+
+        // The host rate mix ramps to that value over the block, against the dry signal delayed as much as the wet one:
+        rateReducer.mix(block, sampleStride, numChannels, blockSize, { startDryWet, (mReducedDryWet - startDryWet) / (float) blockSize });
+    }
+}
+
+template <typename SampleType>
+void FROGGCore::processDelay (SampleType* const* channels, int sampleStride, int numChannels, int numSamples, int factor, int reduction)
+{
+    Engine<SampleType>& engine = getEngine<SampleType>();
+    SampleType* chunk[FROGGMaxChannels];
+
+    // Render the LFO one chunk at a time, every chunk covers a whole number of host samples:
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += FROGGChunkSize) {
+
+        const int chunkSize = std::min(FROGGChunkSize, numSamples - chunkStart);
+
+        // Smoothed parameter ramps for this chunk, scaled to the processing rate:
+        FROGGBlockParameters ramps;
+
+        {
+            FROGG_TRACE_ZONE("Parameter smoothing");
+            ramps = mParameterStage.getNextRamps(chunkSize * reduction / factor).withRateFactor((float) factor / (float) reduction);
+        }
+
+        // Reduced, the chunk stays fully wet, the dry signal is mixed in at the host rate:
+        if (reduction > 1) {
+            mReducedDryWet = ramps.dryWet.at(chunkSize);
+            ramps.dryWet = { 1.0f, 0.0f };
+        }
+
+        // LFO values of every channel and voice, at the control rate of the quality tier:
+        {
+            FROGG_TRACE_ZONE("LFO");
+            mLFO.setNumVoices(ramps.numVoices);
+            mLFO.setControlInterval(ramps.controlInterval);
+            mLFO.process(mLFOChannels.data(), chunkSize, ramps.phaseIncrement, ramps.phaseOffset);
+        }
+
+        // All channels run as lanes of the SIMD kernels, one register of channels at a time:
+        for (int channel = 0; channel < numChannels; channel++) {
+            chunk[channel] = channels[channel] + chunkStart * sampleStride;
+        }
+
+        const float* const* lfo = mLFOChannels.data();
+
+        // Input peak, measured only while a monitor shows it:
+        const bool isMonitored = mMonitor != nullptr && mMonitor->isActive();
+        Monitor::Frame frame {};
+
+        if (isMonitored) {
+            frame.inputLevel = getPeakLevel(chunk, sampleStride, numChannels, chunkSize);
+        }
+
+        {
+            FROGG_TRACE_ZONE("Delay");
+            engine.kernels->processDelay(engine.registerSize, engine.delayLine, engine.feedback, chunk, sampleStride, numChannels, lfo, chunkSize, ramps);
+        }
+
+        if (isMonitored) {
+            // Left / right LFO and delay time of the first voice at the end of the chunk:
+            const int last = chunkSize - 1;
+            const float samplesToMs = 1000.0f / (float) (getSampleRate() * factor / reduction);
+
+            for (int side = 0; side < 2; side++) {
+                const int channel = std::min(side, numChannels - 1);
+                frame.lfo[side] = lfo[channel][last];
+                frame.delayMs[side] = (ramps.delayCentre.at(last) + frame.lfo[side] * ramps.delayDepth.at(last)) * samplesToMs;
+            }
+
+            frame.outputLevel = getPeakLevel(chunk, sampleStride, numChannels, chunkSize);
+            mMonitor->push(frame);
+        }
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void FROGGCore::setProcessingRate (int factor, int reduction)
+{
+    Engine<SampleType>& engine = getEngine<SampleType>();
+    mOversamplingFactor = factor;
+    mRateReduction = reduction;
+
+    // Delay times in samples grow with the rate, the delay line wraps at the length this rate needs:
+    const double sampleRate = getSampleRate() * factor / reduction;
+    engine.delayLine.setMaxDelay((float) (sampleRate * FROGGMaxDelaySeconds) + FROGGMaxInterpolationTapsBehind);
+
+    // Feedback reset:
+    std::fill(std::begin(engine.feedback), std::end(engine.feedback), (SampleType) 0);
+
+    // The dry signal waits for the wet one through the reducer's filters, the half band filters
+    // of the oversampler delay the signal:
+    int latency = 0;
+
+    if (reduction > 1) {
+        engine.rateReducer.reset(getPositionRemainder(mSamplePosition, reduction));
+        mReducedDryWet = mParameterStage.getDryWet();
+        latency = engine.rateReducer.getLatencySamples();
+    }
+    else if (factor > 1) {
+        FROGGOversampler<SampleType>& oversampler = *engine.oversamplers[factor == 2 ? 0 : 1];
+        oversampler.reset();
+        latency = oversampler.getLatencySamples();
+    }
+
+    // The caller reports the change to the host, away from the processing thread:
+    if (mLatency.exchange(latency) != latency) {
+        mLatencyChanged = true;
+    }
+
+    // The LFO samples are a different length now:
+    if (mLFO.isOnTimeline()) {
+        updateLFOTimeline();
+    }
+}
+
+void FROGGCore::updatePrecision()
+{
+    const bool useDoublePrecision = getQualityTier(mParameters.quality).doublePrecision && mDoubleEngineReady;
+
+    if (useDoublePrecision == mUsingDoublePrecision) {
+        // A tier change taken back before the switch fades the wet signal in again:
+        if (mSwitchingPrecision) {
+            mSwitchingPrecision = false;
+            mParameterStage.setWetMuted(mWetMuted);
+            mParameterStage.update(mParameters);
+        }
+
+        return;
+    }
+
+    // The engine taking over starts from an empty delay line, switching under the wet signal would
+    // click: it fades out over the smoothing time first, unless the idle path has nothing to fade:
+    if (! mIsIdle && ! mParameterStage.isWetMuted()) {
+        mSwitchingPrecision = true;
+        mParameterStage.setWetMuted(true);
+        return;
+    }
+
+    // At the rate in use, then the wet signal fades back in to the parameter value:
+    mUsingDoublePrecision = useDoublePrecision;
+    mSwitchingPrecision = false;
+    mParameterStage.setWetMuted(mWetMuted);
+    mParameterStage.update(mParameters);
+
+    if (mUsingDoublePrecision) {
+        setProcessingRate<double>(mOversamplingFactor, mRateReduction);
+    }
+    else {
+        setProcessingRate<float>(mOversamplingFactor, mRateReduction);
+    }
+}
+
+double FROGGCore::computeTailSeconds (float feedback, int type)
+{
+    const FROGGDelayRange& range = type == 0 ? FROGGChorusRange : FROGGFlangerRange;
+
+    // Each round trip scales the ringing by the feedback gain (the voices are averaged, never louder):
+    double numRoundTrips = 1.0;
+
+    if (feedback > 0.0f) {
+        numRoundTrips += std::ceil(std::log((double) silenceThreshold) / std::log((double) std::min(feedback, 0.999f)));
+    }
+
+    // A feedback change may still be ramping:
+    return numRoundTrips * range.maxSeconds + FROGGParameterStage::smoothingTimeSeconds;
+}
+
+template <typename SampleType>
+void FROGGCore::enterIdle()
+{
+    Engine<SampleType>& engine = getEngine<SampleType>();
+    mIsIdle = true;
+
+    // Whatever is left is below the threshold, clear it so waking up starts from silence:
+    engine.delayLine.clear();
+    std::fill(std::begin(engine.feedback), std::end(engine.feedback), (SampleType) 0);
+
+    if (mOversamplingFactor > 1) {
+        engine.oversamplers[mOversamplingFactor == 2 ? 0 : 1]->reset();
+    }
+
+    if (mRateReduction > 1) {
+        engine.rateReducer.reset();
+    }
+}
+
+template <typename SampleType>
+float FROGGCore::getPeakLevel (const SampleType* const* channels, int sampleStride, int numChannels, int numSamples)
+{
+    SampleType peak = 0;
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        const SampleType* samples = channels[channel];
+
+        for (int i = 0; i < numSamples; i++) {
+            const SampleType level = std::abs(samples[i * sampleStride]);
+            peak = level > peak ? level : peak;
+        }
+    }
+
+    return (float) peak;
+}
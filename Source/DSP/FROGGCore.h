@@ -0,0 +1,322 @@
+/*
+  ==============================================================================
+
+    The chorus / flanger without JUCE: smoothing, LFO, modulated delay and
+    mix on buffers the caller owns.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGKernels.h"
+#include "FROGGLFO.h"
+#include "FROGGParameterStage.h"
+#include "FROGGRateReducer.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Up / down sampler the core runs the delay through for 2x and 4x oversampling.
+
+    The filters are left to the application: the plugin wraps juce::dsp::Oversampling
+    (see FROGGAudioProcessor), so the sound of its oversampling stays the same.
+*/
+template <typename SampleType>
+class FROGGOversampler
+{
+public:
+    virtual ~FROGGOversampler() = default;
+
+    // Host samples the up and down filters delay the signal by together:
+    virtual int getLatencySamples() const = 0;
+
+    // Clears the filter state:
+    virtual void reset() = 0;
+
+    // Up samples numSamples of input, sample i of channel c at input[c][i * sampleStride], and
+    // returns the channels of numSamples * factor samples it wrote them to:
+    virtual SampleType* const* processUp (const SampleType* const* input, int sampleStride, int numChannels, int numSamples) = 0;
+
+    // Down samples those channels back into output, laid out like the input of processUp:
+    virtual void processDown (SampleType* const* output, int sampleStride, int numChannels, int numSamples) = 0;
+};
+
+// Builds the oversamplers of a core, when it is prepared:
+class FROGGOversamplerFactory
+{
+public:
+    virtual ~FROGGOversamplerFactory() = default;
+
+    // Oversampler by factor (2 or 4) for numChannels and blocks of up to maxBlockSize host samples:
+    virtual std::unique_ptr<FROGGOversampler<float>> createFloat (int factor, int numChannels, int maxBlockSize) = 0;
+    virtual std::unique_ptr<FROGGOversampler<double>> createDouble (int factor, int numChannels, int maxBlockSize) = 0;
+};
+
+//==============================================================================
+/**
+    Everything the effect does to the audio, in plain C++.
+
+    Parameters come in as a plain struct (setParameters) and are smoothed by
+    FROGGParameterStage; process() runs the LFO, the delay kernels of the CPU's
+    instruction set, the rate reduction and the dry / wet mix in place, on planar
+    channels or on interleaved frames, without copying them: the kernels read
+    and write every sample where it is. Silent input past the tail switches to an
+    idle path that only moves the smoothers and the LFO on.
+
+    Buffers are float or double. A float caller on a double precision quality
+    tier is converted to double and back, once the double engine is prepared
+    (prepareDoubleEngine). Oversampling needs a FROGGOversamplerFactory, without
+    one the core always runs at the host rate.
+
+    prepare, release, prepareDoubleEngine and the setters of the factory and
+    the monitor allocate or free memory and belong on a non real-time thread;
+    everything else is real-time safe. FROGGAudioProcessor wraps one core, the C
+    interface in FROGGCoreC.h another for applications outside C++.
+*/
+class FROGGCore
+{
+public:
+    //==============================================================================
+    using Parameters = FROGGParameterStage::Snapshot;
+
+    // Receives the modulation and levels of every processed chunk, for a display:
+    class Monitor
+    {
+    public:
+        // State at the end of one chunk, left / right are channels 0 and 1 (both 0 on mono):
+        struct Frame
+        {
+            float lfo[2];           // LFO value of the first voice, -1..1
+            float delayMs[2];       // Delay time of the first voice
+            float inputLevel;       // Peak over all channels, before processing
+            float outputLevel;      // Peak over all channels, after processing
+        };
+
+        virtual ~Monitor() = default;
+
+        // Whether frames are wanted at all, nothing is measured otherwise:
+        virtual bool isActive() const = 0;
+
+        // Called from the processing thread, must neither block nor allocate:
+        virtual void push (const Frame& frame) = 0;
+    };
+
+    // Level below which input and tail count as silence (-90 dBFS):
+    static constexpr float silenceThreshold = 0.0000316f;
+
+    //==============================================================================
+    FROGGCore();
+    ~FROGGCore();
+
+    // Builds the oversamplers on the next prepare, nullptr for none:
+    void setOversamplerFactory (FROGGOversamplerFactory* factory) { mOversamplerFactory = factory; }
+
+    // Display the chunks are reported to, nullptr for none:
+    void setMonitor (Monitor* monitor) { mMonitor = monitor; }
+
+    //==============================================================================
+    // Allocates for numChannels (1..FROGGMaxChannels) and blocks of up to maxBlockSize samples, in
+    // double when the caller's buffers are (doublePrecision), and starts from silence with the
+    // parameters at their values:
+    void prepare (double sampleRate, int numChannels, int maxBlockSize, bool doublePrecision, const Parameters& parameters);
+
+    // Frees the memory, prepare has to be called again before processing:
+    void release();
+
+    bool isPrepared() const { return mNumChannels > 0; }
+
+    // Clears the delay, feedback and filters and jumps to the current parameter values:
+    void reset();
+
+    // True when a float caller is on a double precision tier but the double engine is not prepared,
+    // which prepareDoubleEngine does, away from the processing thread. The float engine runs until then:
+    bool needsDoubleEngine() const;
+    void prepareDoubleEngine();
+
+    //==============================================================================
+    // New parameter targets, the sound ones are smoothed from where they are. Once per block, or
+    // between two process calls splitting a block where a change lands:
+    void setParameters (const Parameters& parameters);
+
+    const Parameters& getParameters() const { return mParameters; }
+
+    // Leaves the idle path and counts the silence from the next process call on, for a caller about
+    // to split a block on timed changes:
+    void wakeUp();
+
+    // Fades the wet signal out (true) or back in, see FROGGParameterStage::setWetMuted:
+    void setWetMuted (bool shouldBeMuted);
+    bool isWetMuted() const { return mWetMuted && mParameterStage.isWetMuted(); }
+
+    // Puts the LFO on a timeline: samplePosition, the host sample the next block starts at, is at
+    // phase (in cycles), and from there the phase of every sample is worked out in double from its
+    // position at the rate parameter, so it only depends on where the sample lies on the timeline,
+    // not on the block sizes or where processing started. Call it when the timeline jumps rather
+    // than every block; a new rate carries on from the phase reached. The rate reduction groups
+    // are kept on multiples of the reduction on the timeline as well:
+    void syncLFOToTimeline (double phase, long long samplePosition);
+
+    // Lets the LFO run free again from the phase it reached:
+    void releaseLFOFromTimeline() { mLFO.reset(mLFO.getPhase(), mLFO.getSamplePosition()); }
+    bool isLFOOnTimeline() const { return mLFO.isOnTimeline(); }
+
+    //==============================================================================
+    // Processes numSamples of numChannels planar channels in place. numChannels is at most the number
+    // prepared, and numSamples any length. Buffers of the other precision than prepared for pass
+    // through unchanged:
+    void process (float* const* channels, int numChannels, int numSamples);
+    void process (double* const* channels, int numChannels, int numSamples);
+
+    // Processes numFrames interleaved frames of numChannels samples in place:
+    void processInterleaved (float* frames, int numChannels, int numFrames);
+    void processInterleaved (double* frames, int numChannels, int numFrames);
+
+    //==============================================================================
+    // Host samples the output lags the input by, from the oversampling or rate reduction filters.
+    // Changes with those parameters, during process:
+    int getLatencySamples() const { return mLatency; }
+
+    // Whether the latency changed during process since prepare or the last checkLatencyChanged. The
+    // processing thread can poll isLatencyChangePending, the thread telling the host about it takes
+    // the change with checkLatencyChanged:
+    bool isLatencyChangePending() const { return mLatencyChanged; }
+    bool checkLatencyChanged() { return mLatencyChanged.exchange(false); }
+
+    double getSampleRate() const { return mParameterStage.getSampleRate(); }
+
+    // Seconds until the output falls below silenceThreshold once the input stops: the longest
+    // delay of the type, once plus every round trip of the feedback loop it takes to die away:
+    static double computeTailSeconds (float feedback, int type);
+
+private:
+    //==============================================================================
+    // Delay memory, feedback and resampling filters in one sample type. Only the engine of
+    // the caller's precision is prepared, and the double one for a float caller on a double
+    // precision tier:
+    template <typename SampleType>
+    struct Engine
+    {
+        // Allocates for numChannels at up to the highest oversampling factor:
+        void prepare (double sampleRate, int numChannels, int maxBlockSize, FROGGOversamplerFactory* oversamplerFactory);
+        void release();
+
+        // Kernels the delay line is laid out for, and their register width in lanes:
+        const FROGGKernels* kernels = nullptr;
+        int registerSize = 0;
+
+        // Circular buffer shared by all channels (one lane each):
+        FROGGDelayLine<SampleType> delayLine;
+
+        // Feedback to send to input, one value per channel:
+        SampleType feedback[FROGGMaxChannels] = {};
+
+        // Up / down samplers for 2x and 4x, when there is a factory:
+        std::unique_ptr<FROGGOversampler<SampleType>> oversamplers[2];
+
+        // Half band down / up samplers taking the wet path of a high rate session to 44.1 / 48 kHz:
+        FROGGRateReducer<SampleType> rateReducer;
+    };
+
+    template <typename SampleType>
+    Engine<SampleType>& getEngine();
+
+    // process and processInterleaved for either precision, samples sampleStride apart:
+    template <typename SampleType>
+    void processChannels (SampleType* const* channels, int sampleStride, int numChannels, int numSamples);
+
+    // processChannels of a float caller through the double engine:
+    void processInDouble (float* const* channels, int sampleStride, int numChannels, int numSamples);
+
+    // Runs numSamples through the delay at the processing rate the parameters ask for:
+    template <typename SampleType>
+    void processSegment (SampleType* const* channels, int sampleStride, int numChannels, int numSamples);
+
+    // processSegment with the rate reduction on: the delay runs fully wet at the reduced rate, the
+    // latency aligned dry signal is mixed in at the host rate:
+    template <typename SampleType>
+    void processReduced (SampleType* const* channels, int sampleStride, int numChannels, int numSamples);
+
+    // Runs numSamples of channels at factor times the host rate, divided by reduction, through
+    // the LFO and delay kernels:
+    template <typename SampleType>
+    void processDelay (SampleType* const* channels, int sampleStride, int numChannels, int numSamples, int factor, int reduction);
+
+    // Switches the delay line, oversampler or rate reducer and latency to a new oversampling factor
+    // (1, 2 or 4) or rate reduction (1, 2 or 4, the oversampling is off while it is above 1):
+    template <typename SampleType>
+    void setProcessingRate (int factor, int reduction);
+
+    // Gives the LFO the timeline of syncLFOToTimeline at the processing rate, from the next sample on:
+    void updateLFOTimeline();
+
+    // Switches to the double engine once it is prepared for a tier that asks for it, and back.
+    // The engine taking over starts from silence, so the wet signal fades out first:
+    void updatePrecision();
+
+    // Clears the delay, feedback and filter state when the idle path takes over:
+    template <typename SampleType>
+    void enterIdle();
+
+    // Starts the rate reduction group in progress over, as far into it as the sample count is:
+    void regroupRateReducer();
+
+    // Largest absolute sample over numChannels channels:
+    template <typename SampleType>
+    static float getPeakLevel (const SampleType* const* channels, int sampleStride, int numChannels, int numSamples);
+
+    //==============================================================================
+    Parameters mParameters;
+
+    // Per block parameter ramps for the DSP loop:
+    FROGGParameterStage mParameterStage;
+
+    // LFO and the chunk of left / right modulation values it renders for every voice:
+    FROGGLFO mLFO;
+    std::vector<float> mLFOMemory;
+    std::vector<float*> mLFOChannels;
+
+    // Single and double precision processing state:
+    Engine<float> mFloatEngine;
+    Engine<double> mDoubleEngine;
+
+    // Whether the caller processes in double, whether the double engine is prepared for a float
+    // one and running, and the samples converted for it:
+    bool mDoublePrecisionCaller;
+    std::atomic<bool> mDoubleEngineReady;
+    bool mUsingDoublePrecision;
+    std::vector<double> mPrecisionBuffer;
+
+    // Wet signal muted by the caller, and by a precision switch waiting for it to fade out:
+    bool mWetMuted;
+    bool mSwitchingPrecision;
+
+    FROGGOversamplerFactory* mOversamplerFactory;
+    Monitor* mMonitor;
+
+    // Channels prepared, 0 while released, and the largest block the filters take:
+    int mNumChannels;
+    int mMaxBlockSize;
+
+    // Oversampling factor and rate reduction in use, the latency they add and whether it changed:
+    int mOversamplingFactor;
+    int mRateReduction;
+    std::atomic<int> mLatency;
+    std::atomic<bool> mLatencyChanged;
+
+    // Dry / wet value the reduced delay reached, where the host rate mix of the next block starts:
+    float mReducedDryWet;
+
+    // Host samples of silent input in a row, and whether the idle path is running:
+    long long mNumSilentSamples;
+    bool mIsIdle;
+
+    // Host sample the next process call starts at, counted from prepare or set by syncLFOToTimeline,
+    // and the phase of the LFO timeline at one of them:
+    long long mSamplePosition;
+    double mTimelinePhase;
+    long long mTimelinePosition;
+};
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    C interface of FROGGCore, for applications that are not written in C++
+    or load the effect from a shared library.
+
+  ==============================================================================
+*/
+
+#include "FROGGCoreC.h"
+#include "FROGGCore.h"
+
+#include <new>
+
+//==============================================================================
+struct FROGGCoreInstance
+{
+    FROGGCore core;
+};
+
+namespace
+{
+    FROGGCore::Parameters toParameters (const FROGGCoreParams& params)
+    {
+        FROGGCore::Parameters parameters;
+        parameters.dryWet = params.dryWet;
+        parameters.depth = params.depth;
+        parameters.rate = params.rate;
+        parameters.phaseOffset = params.phaseOffset;
+        parameters.feedback = params.feedback;
+        parameters.type = params.type;
+        parameters.voices = params.voices < 1 ? 1 : (params.voices > FROGGMaxVoices ? FROGGMaxVoices : params.voices);
+        parameters.interpolation = params.interpolation;
+        parameters.quality = params.quality;
+        parameters.rateReduction = params.rateReduction != 0;
+        return parameters;
+    }
+}
+
+//==============================================================================
+void frogg_core_default_params (FROGGCoreParams* params)
+{
+    const FROGGCore::Parameters parameters;
+
+    params->dryWet = parameters.dryWet;
+    params->depth = parameters.depth;
+    params->rate = parameters.rate;
+    params->phaseOffset = parameters.phaseOffset;
+    params->feedback = parameters.feedback;
+    params->type = parameters.type;
+    params->voices = parameters.voices;
+    params->interpolation = parameters.interpolation;
+    params->quality = parameters.quality;
+    params->rateReduction = parameters.rateReduction ? 1 : 0;
+}
+
+FROGGCoreInstance* frogg_core_create (double sampleRate, int numChannels, int maxBlockSize, int doublePrecision, const FROGGCoreParams* params)
+{
+    if (sampleRate <= 0.0 || numChannels < 1 || numChannels > FROGGMaxChannels || maxBlockSize < 1 || params == nullptr)
+        return nullptr;
+
+    // No exception may cross into C:
+    FROGGCoreInstance* instance = new (std::nothrow) FROGGCoreInstance();
+
+    if (instance == nullptr)
+        return nullptr;
+
+    try {
+        instance->core.prepare(sampleRate, numChannels, maxBlockSize, doublePrecision != 0, toParameters(*params));
+    }
+    catch (const std::bad_alloc&) {
+        delete instance;
+        return nullptr;
+    }
+
+    return instance;
+}
+
+void frogg_core_destroy (FROGGCoreInstance* instance)
+{
+    delete instance;
+}
+
+void frogg_core_set_params (FROGGCoreInstance* instance, const FROGGCoreParams* params)
+{
+    instance->core.setParameters(toParameters(*params));
+}
+
+int frogg_core_prepare_double_engine (FROGGCoreInstance* instance)
+{
+    try {
+        instance->core.prepareDoubleEngine();
+    }
+    catch (const std::bad_alloc&) {
+        return 0;
+    }
+
+    return 1;
+}
+
+void frogg_core_reset (FROGGCoreInstance* instance)
+{
+    instance->core.reset();
+}
+
+void frogg_core_process_planar_float (FROGGCoreInstance* instance, float* const* channels, int numChannels, int numSamples)
+{
+    instance->core.process(channels, numChannels, numSamples);
+}
+
+void frogg_core_process_planar_double (FROGGCoreInstance* instance, double* const* channels, int numChannels, int numSamples)
+{
+    instance->core.process(channels, numChannels, numSamples);
+}
+
+void frogg_core_process_interleaved_float (FROGGCoreInstance* instance, float* frames, int numChannels, int numFrames)
+{
+    instance->core.processInterleaved(frames, numChannels, numFrames);
+}
+
+void frogg_core_process_interleaved_double (FROGGCoreInstance* instance, double* frames, int numChannels, int numFrames)
+{
+    instance->core.processInterleaved(frames, numChannels, numFrames);
+}
+
+int frogg_core_get_latency (const FROGGCoreInstance* instance)
+{
+    return instance->core.getLatencySamples();
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    C interface of FROGGCore, for applications that are not written in C++
+    or load the effect from a shared library.
+
+  ==============================================================================
+*/
+
+#ifndef FROGG_CORE_C_H
+#define FROGG_CORE_C_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+/**
+    One instance of the effect, created and destroyed by the functions below.
+
+    Buffers always belong to the caller and are processed in place, planar
+    (one pointer per channel) or interleaved (the samples of a frame next to
+    each other). frogg_core_create, frogg_core_destroy and
+    frogg_core_prepare_double_engine allocate or free memory; every other call
+    is real-time safe. An instance is used by one thread at a time.
+*/
+typedef struct FROGGCoreInstance FROGGCoreInstance;
+
+// Parameter values, the ranges of the plugin's parameters:
+typedef struct FROGGCoreParams
+{
+    float dryWet;           // 0 dry .. 1 wet
+    float depth;            // 0 .. 1
+    float rate;             // LFO rate, 0.1 .. 20 Hz
+    float phaseOffset;      // LFO offset of the last channel, 0 .. 1.1 cycles
+    float feedback;         // 0 .. 0.98
+    int type;               // 0 Chorus, 1 Flanger
+    int voices;             // 1 .. 8
+    int interpolation;      // 0 Linear, 1 Hermite, 2 Lagrange, 3 Sinc, 4 the quality tier's
+    int quality;            // 0 Eco, 1 Standard, 2 High, 3 Ultra
+    int rateReduction;      // Non zero runs the wet path of 88.2 kHz and higher rates at 44.1 / 48 kHz
+} FROGGCoreParams;
+
+// Fills params with the values of a new plugin instance:
+void frogg_core_default_params (FROGGCoreParams* params);
+
+// Creates an instance for numChannels (1..16) and blocks of up to maxBlockSize samples, processing
+// double buffers when doublePrecision is non zero and float ones otherwise. NULL when it fails:
+FROGGCoreInstance* frogg_core_create (double sampleRate, int numChannels, int maxBlockSize, int doublePrecision, const FROGGCoreParams* params);
+
+void frogg_core_destroy (FROGGCoreInstance* instance);
+
+// New parameter values, smoothed from the current ones over 50 ms:
+void frogg_core_set_params (FROGGCoreInstance* instance, const FROGGCoreParams* params);
+
+// A float instance moved to a double precision tier (Ultra) keeps processing in float until
+// this is called, away from the processing thread. 0 when the memory could not be allocated:
+int frogg_core_prepare_double_engine (FROGGCoreInstance* instance);
+
+// Clears the delay and filters, as if the instance had just been created:
+void frogg_core_reset (FROGGCoreInstance* instance);
+
+// Processes numSamples of numChannels planar channels in place. Only the functions of the
+// precision the instance was created for (doublePrecision) process, the others leave the
+// buffers unchanged:
+void frogg_core_process_planar_float (FROGGCoreInstance* instance, float* const* channels, int numChannels, int numSamples);
+void frogg_core_process_planar_double (FROGGCoreInstance* instance, double* const* channels, int numChannels, int numSamples);
+
+// Processes numFrames interleaved frames of numChannels samples in place:
+void frogg_core_process_interleaved_float (FROGGCoreInstance* instance, float* frames, int numChannels, int numFrames);
+void frogg_core_process_interleaved_double (FROGGCoreInstance* instance, double* frames, int numChannels, int numFrames);
+
+// Samples the output lags the input by, changes with the rate reduction:
+int frogg_core_get_latency (const FROGGCoreInstance* instance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,322 @@
+/*
+  ==============================================================================
+
+    Modulated delay kernel that runs a group of channels as lanes of one register.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+#include "FROGGDelayLine.h"
+#include "FROGGInterpolators.h"
+#include "FROGGSIMD.h"
+#include "FROGGTrace.h"
+
+#include <cmath>
+#include <type_traits>
+
+//==============================================================================
+// Longest run of samples whose delayed values are read before any of them is written:
+static constexpr int FROGGMaxSubBlockSize = 64;
+
+//==============================================================================
+/**
+    Number of samples, up to FROGGMaxSubBlockSize, whose reads only reach frames
+    written before the first of them, for the shortest delay of the block.
+
+    The delay never drops below the type's minimum (1 ms flanger, 5 ms chorus),
+    so a sub-block that long can read every delayed sample first, then write
+    the inputs with their feedback. Zero or less when the delay is shorter than
+    the interpolator reaches ahead and the samples have to alternate.
+*/
+template <typename Interpolator>
+FROGG_FORCE_INLINE int FROGGGetSubBlockSize (const FROGGBlockParameters& ramps, int numSamples, const Interpolator& interpolator)
+{
+    // The ramps are linear, so the shortest delay sits at one end of the block:
+    const int last = numSamples - 1;
+    const float firstDelay = ramps.delayCentre.at(0) - std::abs(ramps.delayDepth.at(0));
+    const float lastDelay = ramps.delayCentre.at(last) - std::abs(ramps.delayDepth.at(last));
+
+    // One sample of margin for the rounding of the LFO and the read head:
+    const int subBlockSize = (int) std::floor(firstDelay < lastDelay ? firstDelay : lastDelay) - interpolator.getTapsAhead() - 1;
+
+    return subBlockSize < FROGGMaxSubBlockSize ? subBlockSize : FROGGMaxSubBlockSize;
+}
+
+//==============================================================================
+/**
+    Writes, modulates, reads, feeds back and mixes NumLanes channels.
+
+    The channels use the lanes firstLane.. of the delay line frames. channels are
+    processed in place, sample i of channel c at channels[c][i * sampleStride] (1 for
+    planar buffers, the number of channels for interleaved ones), lfo holds the LFO value of every sample for each voice
+    and channel (-1..1), voice v of channel c at lfo[v * lfoVoiceStride + c], and
+    ramps the smoothed block parameters. All ramps.numVoices read heads of a
+    channel share the one write head and are averaged. feedbackState keeps the
+    delayed signal sent back to the input, one value per lane, between calls.
+
+    The samples run in sub-blocks (see FROGGGetSubBlockSize). Every delayed
+    sample of a sub-block is read first: delay times, read heads and the
+    interpolation a register of samples at a time along each channel, the taps
+    gathered from the delay line. The inputs are then written with their feedback and mixed, all
+    channels of a sample in one register. Only the feedback value passes from
+    one sample to the next, and it is already known, so the result matches a
+    sample by sample loop exactly. Everything is done in the sample type of Vec.
+
+    HasFeedback and IsEnsemble are fixed per instantiation: without feedback the
+    write skips the feedback add and the state is left at zero, and a single
+    voice loses the voice loop and the averaging multiply.
+
+    The delay line write head is left where it was, so every lane group of a
+    block starts from the same frame; the caller advances it afterwards.
+    delayLine needs numTaps - 1 guard frames for the interpolator.
+*/
+template <typename Vec, int NumLanes, typename Interpolator, bool HasFeedback, bool IsEnsemble>
+void FROGGProcessDelay (FROGGDelayLine<typename Vec::SampleType>& delayLine, int firstLane, typename Vec::SampleType* feedbackState,
+                        typename Vec::SampleType* const* channels, int sampleStride, const float* const* lfo, int lfoVoiceStride,
+                        int numSamples, const FROGGBlockParameters& ramps, const Interpolator& interpolator)
+{
+    static_assert (NumLanes <= Vec::size, "More channels than lanes in the register");
+    static_assert (FROGGMaxSubBlockSize % Vec::size == 0, "Sub-blocks must hold whole registers");
+
+    using SampleType = typename Vec::SampleType;
+
+    const int numVoices = IsEnsemble ? ramps.numVoices : 1;
+    const Vec voiceGain = Vec::broadcast((SampleType) 1 / (SampleType) numVoices);
+
+    const int firstWriteHead = delayLine.getWriteHead();
+    const int mask = delayLine.getMask();
+    Vec feedback = Vec::load(feedbackState);
+
+    alignas (64) SampleType lanes[Vec::size] = {};
+
+    // Sub-block state along time, and the delayed samples of every lane:
+    alignas (64) int writePosition[FROGGMaxSubBlockSize];
+    alignas (64) SampleType delayCentre[FROGGMaxSubBlockSize];
+    alignas (64) SampleType delayDepth[FROGGMaxSubBlockSize];
+    alignas (64) SampleType modulation[FROGGMaxSubBlockSize] = {};
+    alignas (64) SampleType interpolated[FROGGMaxSubBlockSize];
+    alignas (64) int index[Vec::size];
+    alignas (64) SampleType delayed[FROGGMaxSubBlockSize * Vec::size];
+
+    // Delayed samples start..end - 1 of every lane into delayed, sample i - start at (i - start) * Vec::size:
+    auto read = [&] (int start, int end)
+    {
+        const int numSubBlockSamples = end - start;
+        const int numRegisters = (numSubBlockSamples + Vec::size - 1) / Vec::size;
+
+        for (int i = 0; i < numRegisters * Vec::size; i++) {
+            writePosition[i] = (firstWriteHead + start + i) & mask;
+            delayCentre[i] = (SampleType) ramps.delayCentre.at(start + i);
+            delayDepth[i] = (SampleType) ramps.delayDepth.at(start + i);
+        }
+
+        for (int i = 0; i < numSubBlockSamples * Vec::size; i++) {
+            delayed[i] = 0;
+        }
+
+        for (int v = 0; v < numVoices; v++) {
+            for (int c = 0; c < NumLanes; c++) {
+                const float* voiceLFO = lfo[v * lfoVoiceStride + c] + start;
+
+                for (int i = 0; i < numSubBlockSamples; i++) {
+                    modulation[i] = (SampleType) voiceLFO[i];
+                }
+
+                // Delay times in samples from the LFO, depth and the type's delay range, the read heads
+                // split into integer and fractional parts and the interpolated samples, a register of
+                // samples at a time. Samples past the sub-block read masked frames and are left out.
+                // The delay is split rather than the read head, so the fraction is as fine wherever
+                // the write head is in the buffer:
+                for (int i = 0; i < numRegisters * Vec::size; i += Vec::size) {
+                    const Vec delayTime = Vec::load(delayCentre + i) + Vec::load(modulation + i) * Vec::load(delayDepth + i);
+                    const Vec fraction = Vec::broadcast((SampleType) 1) - (delayTime - Vec::floor(delayTime, index));
+
+                    for (int k = 0; k < Vec::size; k++) {
+                        index[k] = writePosition[i + k] - index[k] - 1;
+                    }
+
+                    interpolator.interpolate(delayLine, index, fraction, firstLane + c).store(interpolated + i);
+                }
+
+                // Summed over the voices:
+                for (int i = 0; i < numSubBlockSamples; i++) {
+                    delayed[i * Vec::size + c] += interpolated[i];
+                }
+            }
+        }
+    };
+
+    // Circular buffer write with the feedback of the sample before, feedback for the next one
+    // and dry / wet mix, all channels of the group in one register:
+    auto writeAndMix = [&] (int i, const SampleType* delayedLanes)
+    {
+        for (int c = 0; c < NumLanes; c++) {
+            lanes[c] = channels[c][i * sampleStride];
+        }
+
+        const Vec input = Vec::load(lanes);
+        Vec delayedSample = Vec::load(delayedLanes);
+
+        if constexpr (IsEnsemble) {
+            delayedSample = delayedSample * voiceGain;
+        }
+
+        const int writeHead = (firstWriteHead + i) & mask;
+
+        if constexpr (HasFeedback) {
+            delayLine.write(input + feedback, writeHead, firstLane);
+            feedback = delayedSample * Vec::broadcast((SampleType) ramps.feedback.at(i));
+        }
+        else {
+            delayLine.write(input, writeHead, firstLane);
+        }
+
+        const Vec output = input + (delayedSample - input) * Vec::broadcast((SampleType) ramps.dryWet.at(i));
+        output.store(lanes);
+
+        for (int c = 0; c < NumLanes; c++) {
+            channels[c][i * sampleStride] = lanes[c];
+        }
+    };
+
+    const int subBlockSize = FROGGGetSubBlockSize(ramps, numSamples, interpolator);
+
+    if (subBlockSize < 1) {
+        // Delays within the interpolator's reach read the sample just written, so it is written first,
+        // one sample at a time (only at very low rates):
+        for (int i = 0; i < numSamples; i++) {
+            for (int c = 0; c < NumLanes; c++) {
+                lanes[c] = channels[c][i * sampleStride];
+            }
+
+            if constexpr (HasFeedback) {
+                delayLine.write(Vec::load(lanes) + feedback, (firstWriteHead + i) & mask, firstLane);
+            }
+            else {
+                delayLine.write(Vec::load(lanes), (firstWriteHead + i) & mask, firstLane);
+            }
+
+            read(i, i + 1);
+
+            // Writing the same frame again stores the same value:
+            writeAndMix(i, delayed);
+        }
+    }
+    else {
+        for (int subBlockStart = 0; subBlockStart < numSamples; subBlockStart += subBlockSize) {
+
+            const int subBlockEnd = subBlockStart + subBlockSize < numSamples ? subBlockStart + subBlockSize : numSamples;
+
+            // Every frame these reads reach was written before the sub-block:
+            {
+                FROGG_TRACE_ZONE("Interpolation");
+                read(subBlockStart, subBlockEnd);
+            }
+
+            // Write and mix are one pass over the same registers, they share a zone:
+            FROGG_TRACE_ZONE("Buffer write and mix");
+
+            for (int i = subBlockStart; i < subBlockEnd; i++) {
+                writeAndMix(i, delayed + (i - subBlockStart) * Vec::size);
+            }
+        }
+    }
+
+    if constexpr (HasFeedback) {
+        feedback.store(feedbackState);
+    }
+    else {
+        Vec::broadcast(0).store(feedbackState);
+    }
+}
+
+//==============================================================================
+/**
+    Picks the kernel compiled for exactly numLanes active lanes (1..Vec::size),
+    so mono, stereo or the last partial group of a surround bus never gathers,
+    loads or stores lanes it does not use.
+*/
+template <typename Vec, typename Interpolator, bool HasFeedback, bool IsEnsemble, int NumLanes = Vec::size>
+void FROGGProcessDelayLanes (int numLanes, FROGGDelayLine<typename Vec::SampleType>& delayLine, int firstLane, typename Vec::SampleType* feedbackState,
+                             typename Vec::SampleType* const* channels, int sampleStride, const float* const* lfo, int lfoVoiceStride,
+                             int numSamples, const FROGGBlockParameters& ramps, const Interpolator& interpolator)
+{
+    if constexpr (NumLanes > 1) {
+        if (numLanes < NumLanes) {
+            FROGGProcessDelayLanes<Vec, Interpolator, HasFeedback, IsEnsemble, NumLanes - 1>(numLanes, delayLine, firstLane, feedbackState,
+                                                                                             channels, sampleStride, lfo, lfoVoiceStride, numSamples, ramps, interpolator);
+            return;
+        }
+    }
+
+    FROGGProcessDelay<Vec, NumLanes, Interpolator, HasFeedback, IsEnsemble>(delayLine, firstLane, feedbackState, channels, sampleStride, lfo, lfoVoiceStride,
+                                                                            numSamples, ramps, interpolator);
+}
+
+//==============================================================================
+/**
+    Runs any number of channels through the delay, Vec::size channels at a time,
+    then advances the shared write head. Channel c uses lane c of the delay line
+    frames and feedbackState[c], its samples sampleStride apart; lfo is laid out as for FROGGProcessDelay with
+    numChannels as the voice stride.
+
+    The interpolator, whether feedback is in use and whether there is more than
+    one voice are decided once per block, every combination compiles to its own
+    loop. The chorus / flanger type needs no specialisation of its own, it only
+    changes the delay ramps the block already carries.
+*/
+template <typename Vec>
+void FROGGProcessDelayChannels (FROGGDelayLine<typename Vec::SampleType>& delayLine, typename Vec::SampleType* feedbackState,
+                                typename Vec::SampleType* const* channels, int sampleStride, int numChannels,
+                                const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps)
+{
+    static_assert (FROGGMaxChannels % Vec::size == 0, "The feedback state must hold whole registers");
+
+    auto processWith = [&] (const auto& interpolator, auto hasFeedback, auto isEnsemble)
+    {
+        using Interpolator = std::decay_t<decltype (interpolator)>;
+
+        for (int firstLane = 0; firstLane < numChannels; firstLane += Vec::size) {
+            const int numLanes = numChannels - firstLane < Vec::size ? numChannels - firstLane : Vec::size;
+
+            FROGGProcessDelayLanes<Vec, Interpolator, decltype (hasFeedback)::value, decltype (isEnsemble)::value>(
+                numLanes, delayLine, firstLane, feedbackState + firstLane,
+                channels + firstLane, sampleStride, lfo + firstLane, numChannels, numSamples, ramps, interpolator);
+        }
+    };
+
+    // Feedback only drops out when it is held at zero for the whole block:
+    const bool hasFeedback = ramps.feedback.start != 0.0f || ramps.feedback.step != 0.0f;
+    const bool isEnsemble = ramps.numVoices > 1;
+
+    auto processWithModes = [&] (const auto& interpolator)
+    {
+        if (hasFeedback) {
+            if (isEnsemble) processWith(interpolator, std::true_type(), std::true_type());
+            else            processWith(interpolator, std::true_type(), std::false_type());
+        }
+        else {
+            if (isEnsemble) processWith(interpolator, std::false_type(), std::true_type());
+            else            processWith(interpolator, std::false_type(), std::false_type());
+        }
+    };
+
+    if (ramps.interpolation == FROGGInterpolation::linear) {
+        processWithModes(FROGGLinearInterpolator());
+    }
+    else {
+        const FROGGInterpolationTable& table = FROGGInterpolationTable::get(ramps.interpolation);
+
+        if (table.paddedTaps == 4) {
+            processWithModes(FROGGTableInterpolator<4> { table.coefficients, table.firstTap });
+        }
+        else {
+            processWithModes(FROGGTableInterpolator<8> { table.coefficients, table.firstTap });
+        }
+    }
+
+    delayLine.advance(numSamples);
+}
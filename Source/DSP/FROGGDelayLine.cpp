@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    Power of two, interleaved delay line for the modulated read heads.
+
+  ==============================================================================
+*/
+
+#include "FROGGDelayLine.h"
+
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+namespace
+{
+    // Smallest power of two holding maxDelaySamples of history:
+    int lengthForDelay (float maxDelaySamples)
+    {
+        // The read head reaches floor (writeHead - maxDelay), and the frame after it is read too:
+        const int requiredLength = (int) std::ceil(maxDelaySamples) + 2;
+
+        int length = 1;
+
+        while (length < requiredLength) {
+            length <<= 1;
+        }
+
+        return length;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void FROGGDelayLine<SampleType>::prepare (float maxDelaySamples, int numLanes, int numGuardFrames)
+{
+    mCapacity = lengthForDelay(maxDelaySamples);
+    mStride = numLanes;
+    mNumGuardFrames = numGuardFrames;
+
+    // The pool hands out floats, a double line takes two of them per sample:
+    const size_t size = (size_t) (mCapacity + mNumGuardFrames) * (size_t) mStride * (sizeof (SampleType) / sizeof (float));
+
+    // The block held is kept whenever it is big enough, a new one replaces it only to grow:
+    if (mMemory.getCapacity() < size) {
+        mMemory.release();
+        mMemory = FROGGMemoryPool::getInstance().acquire(size);
+    }
+
+    setMaxDelay(maxDelaySamples);
+}
+
+template <typename SampleType>
+void FROGGDelayLine<SampleType>::setMaxDelay (float maxDelaySamples)
+{
+    const int length = lengthForDelay(maxDelaySamples);
+
+    mLength = length < mCapacity ? length : mCapacity;
+
+    clear();
+}
+
+template <typename SampleType>
+void FROGGDelayLine<SampleType>::clear()
+{
+    if (mMemory.get() != nullptr) {
+        std::memset(mMemory.get(), 0, getSizeInBytes());
+    }
+
+    mWriteHead = 0;
+}
+
+template <typename SampleType>
+void FROGGDelayLine<SampleType>::release()
+{
+    mMemory.release();
+    mCapacity = 0;
+    mLength = 0;
+    mWriteHead = 0;
+}
+
+//==============================================================================
+template class FROGGDelayLine<float>;
+template class FROGGDelayLine<double>;
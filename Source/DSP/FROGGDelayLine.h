@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    Power of two, interleaved delay line for the modulated read heads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+#include "FROGGMemoryPool.h"
+
+//==============================================================================
+/**
+    Circular delay memory sized to the longest modulated delay instead of a
+    fixed number of seconds.
+
+    Frames are interleaved: all channels of a sample sit next to each other,
+    grouped by register width (a group of lanes per SIMD register, the last
+    group padded), so one allocation holds every channel contiguously.
+    The memory comes from FROGGMemoryPool and is only replaced when a prepare
+    needs more than the block already held.
+    The length is a power of two so every wrap is a mask, and the first frames
+    are mirrored after the end (the guard region), so an interpolator that
+    starts reading at a masked index can read its following points without
+    another wrap or branch.
+    SampleType is float or double, matching the precision the host processes in.
+*/
+template <typename SampleType>
+class FROGGDelayLine
+{
+public:
+    //==============================================================================
+    // Makes sure there is room for maxDelaySamples of history on numLanes lanes,
+    // plus numGuardFrames mirrored frames for the interpolation points past the end:
+    void prepare (float maxDelaySamples, int numLanes, int numGuardFrames);
+
+    // Shrinks (or grows back, up to what prepare allocated) the part of the memory the heads
+    // cycle through, without allocating, and clears it. Keeps the working set small when
+    // a lower rate needs less history than the prepared maximum:
+    void setMaxDelay (float maxDelaySamples);
+
+    // Zeroes the memory and resets the write head:
+    void clear();
+
+    // Gives the memory back to the pool, prepare has to be called again before use:
+    void release();
+
+    //==============================================================================
+    FROGG_FORCE_INLINE int getLength() const       { return mLength; }
+    FROGG_FORCE_INLINE int getMask() const         { return mLength - 1; }
+    FROGG_FORCE_INLINE int getStride() const       { return mStride; }
+    FROGG_FORCE_INLINE int getWriteHead() const    { return mWriteHead; }
+
+    // First lane of a masked frame, valid up to numGuardFrames frames further:
+    FROGG_FORCE_INLINE SampleType* getFrame (int maskedIndex) const { return reinterpret_cast<SampleType*> (mMemory.get()) + maskedIndex * mStride; }
+
+    // Stores one register of lanes, starting at firstLane, into the masked frame writeHead,
+    // mirroring it into the guard region when needed:
+    template <typename Vec>
+    FROGG_FORCE_INLINE void write (Vec lanes, int writeHead, int firstLane)
+    {
+        lanes.store(getFrame(writeHead) + firstLane);
+
+        if (writeHead < mNumGuardFrames) {
+            lanes.store(getFrame(writeHead + mLength) + firstLane);
+        }
+    }
+
+    // Moves the write head once every lane group has written its samples:
+    FROGG_FORCE_INLINE void advance (int numSamples)  { mWriteHead = (mWriteHead + numSamples) & (mLength - 1); }
+
+    // Bytes of delay memory, the working set of the read and write heads:
+    size_t getSizeInBytes() const { return (size_t) (mLength + mNumGuardFrames) * (size_t) mStride * sizeof (SampleType); }
+
+private:
+    //==============================================================================
+    FROGGMemoryPool::Block mMemory;
+    int mCapacity = 0;
+    int mLength = 0;
+    int mStride = 0;
+    int mNumGuardFrames = 0;
+    int mWriteHead = 0;
+};
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    Fractional delay interpolators for the modulated read heads.
+
+  ==============================================================================
+*/
+
+#include "FROGGInterpolators.h"
+
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    // Zeroth order modified Bessel function, for the Kaiser window:
+    double besselI0 (double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Weight of tap k (relative to the integer read position) for a fractional position t:
+    double hermiteWeight (int k, double t)
+    {
+        // 4-point, 3rd order Hermite (Catmull-Rom) written as weights of x[-1] .. x[2]:
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+
+        switch (k) {
+            case -1: return -0.5 * t3 + t2 - 0.5 * t;
+            case 0:  return 1.5 * t3 - 2.5 * t2 + 1.0;
+            case 1:  return -1.5 * t3 + 2.0 * t2 + 0.5 * t;
+            default: return 0.5 * t3 - 0.5 * t2;
+        }
+    }
+
+    double lagrangeWeight (int k, double t, int firstTap, int numTaps)
+    {
+        double weight = 1.0;
+
+        for (int j = firstTap; j < firstTap + numTaps; j++) {
+            if (j != k) {
+                weight *= (t - j) / (double) (k - j);
+            }
+        }
+
+        return weight;
+    }
+
+    double sincWeight (int k, double t, int numTaps)
+    {
+        // Kaiser windowed sinc, beta 5 (about -60 dB side lobes) over the whole kernel:
+        const double beta = 5.0;
+        const double x = k - t;
+        const double halfLength = numTaps * 0.5;
+        const double pi = 3.14159265358979323846;
+
+        if (std::abs(x) >= halfLength) {
+            return 0.0;
+        }
+
+        const double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+        const double r = x / halfLength;
+
+        return sinc * besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+    }
+
+    //==============================================================================
+    struct Table
+    {
+        Table (FROGGInterpolation interpolation)
+        {
+            int numTaps = 0;
+
+            switch (interpolation) {
+                case FROGGInterpolation::hermite:   numTaps = 4; info.firstTap = -1; break;
+                case FROGGInterpolation::lagrange:  numTaps = 6; info.firstTap = -2; break;
+                case FROGGInterpolation::sinc:      numTaps = 8; info.firstTap = -3; break;
+                case FROGGInterpolation::linear:    numTaps = 2; info.firstTap = 0;  break;
+            }
+
+            info.paddedTaps = (numTaps + 3) / 4 * 4;
+
+            // One extra row so position 1.0 (rounding) still has a next row to blend with:
+            const int numRows = FROGGInterpolationTable::numPhases + 2;
+            coefficients.assign((size_t) (numRows * info.paddedTaps), 0.0f);
+
+            for (int row = 0; row < numRows; row++) {
+                const double t = (double) row / FROGGInterpolationTable::numPhases;
+                float* weights = coefficients.data() + row * info.paddedTaps;
+                double sum = 0.0;
+
+                for (int tap = 0; tap < numTaps; tap++) {
+                    const int k = info.firstTap + tap;
+                    double weight = 0.0;
+
+                    switch (interpolation) {
+                        case FROGGInterpolation::hermite:   weight = hermiteWeight(k, t); break;
+                        case FROGGInterpolation::lagrange:  weight = lagrangeWeight(k, t, info.firstTap, numTaps); break;
+                        case FROGGInterpolation::sinc:      weight = sincWeight(k, t, numTaps); break;
+                        case FROGGInterpolation::linear:    weight = k == 0 ? 1.0 - t : t; break;
+                    }
+
+                    weights[tap] = (float) weight;
+                    sum += weight;
+                }
+
+                // The truncated sinc does not add up to one, normalise it for unity gain at DC:
+                if (interpolation == FROGGInterpolation::sinc) {
+                    for (int tap = 0; tap < numTaps; tap++) {
+                        weights[tap] = (float) (weights[tap] / sum);
+                    }
+                }
+            }
+
+            info.coefficients = coefficients.data();
+        }
+
+        std::vector<float> coefficients;
+        FROGGInterpolationTable info;
+    };
+}
+
+//==============================================================================
+const FROGGInterpolationTable& FROGGInterpolationTable::get (FROGGInterpolation interpolation)
+{
+    static const Table linear (FROGGInterpolation::linear);
+    static const Table hermite (FROGGInterpolation::hermite);
+    static const Table lagrange (FROGGInterpolation::lagrange);
+    static const Table sinc (FROGGInterpolation::sinc);
+
+    switch (interpolation) {
+        case FROGGInterpolation::hermite:   return hermite.info;
+        case FROGGInterpolation::lagrange:  return lagrange.info;
+        case FROGGInterpolation::sinc:      return sinc.info;
+        case FROGGInterpolation::linear:    break;
+    }
+
+    return linear.info;
+}
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    Fractional delay interpolators for the modulated read heads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+#include "FROGGDelayLine.h"
+
+//==============================================================================
+// Longest interpolation kernel, the delay line keeps numTaps - 1 guard frames for it:
+static constexpr int FROGGMaxInterpolationTaps = 8;
+
+// Most frames any kernel reads before the integer read position:
+static constexpr int FROGGMaxInterpolationTapsBehind = 3;
+
+//==============================================================================
+/**
+    Precomputed polyphase coefficients of one interpolator.
+
+    Row p holds the tap weights for a fractional position of p / numPhases, each
+    row padded with zeros to a multiple of four taps so a row is a whole number
+    of SIMD registers. Positions between two rows blend them linearly, so the
+    per-sample cost is a multiply-add per tap, whatever formula built the table.
+*/
+struct FROGGInterpolationTable
+{
+    static constexpr int numPhases = 256;
+
+    const float* coefficients = nullptr;    // numPhases + 2 rows of paddedTaps
+    int paddedTaps = 0;
+    int firstTap = 0;                       // Offset of the first tap from the integer read position
+
+    // Returns the table of a polyphase interpolator, built on first use.
+    // Call it once outside the audio thread (prepareToPlay) so the build never happens there:
+    static const FROGGInterpolationTable& get (FROGGInterpolation interpolation);
+};
+
+//==============================================================================
+// 2-point linear interpolation:
+struct FROGGLinearInterpolator
+{
+    // Frames read past the integer read position:
+    FROGG_FORCE_INLINE int getTapsAhead() const { return 1; }
+
+    // Delayed samples of one lane for a register of read heads along time, sample i at index[i] + fraction lane i.
+    // The guard frame makes index + 1 safe without a wrap:
+    template <typename Vec>
+    FROGG_FORCE_INLINE Vec interpolate (const FROGGDelayLine<typename Vec::SampleType>& delayLine, const int* index, Vec fraction, int lane) const
+    {
+        const int stride = delayLine.getStride();
+        const int mask = delayLine.getMask();
+
+        alignas (64) int offsets[Vec::size];
+
+        for (int i = 0; i < Vec::size; i++) {
+            offsets[i] = (index[i] & mask) * stride + lane;
+        }
+
+        const typename Vec::SampleType* memory = delayLine.getFrame(0);
+
+        const Vec x = Vec::gather(memory, offsets);
+        return x + fraction * (Vec::gather(memory + stride, offsets) - x);
+    }
+};
+
+//==============================================================================
+// Table driven interpolator (Hermite, Lagrange, windowed sinc) with PaddedTaps weights per row.
+// The table stays in float for both sample types, the sum is kept in the sample type:
+template <int PaddedTaps>
+struct FROGGTableInterpolator
+{
+    const float* coefficients;
+    int firstTap;
+
+    // Frames read past the integer read position, padding taps included:
+    FROGG_FORCE_INLINE int getTapsAhead() const { return firstTap + PaddedTaps - 1; }
+
+    // Delayed samples of one lane for a register of read heads along time, as for FROGGLinearInterpolator:
+    template <typename Vec>
+    FROGG_FORCE_INLINE Vec interpolate (const FROGGDelayLine<typename Vec::SampleType>& delayLine, const int* index, Vec fraction, int lane) const
+    {
+        using SampleType = typename Vec::SampleType;
+
+        const int stride = delayLine.getStride();
+        const int mask = delayLine.getMask();
+
+        // Two neighbouring rows of the table and the blend between them, for every sample:
+        alignas (64) int phase[Vec::size];
+        const Vec phasePosition = fraction * Vec::broadcast((SampleType) FROGGInterpolationTable::numPhases);
+        const Vec blend = phasePosition - Vec::floor(phasePosition, phase);
+
+        // Taps are read forward from the first one, the guard frames cover the end of the buffer:
+        alignas (64) int rowOffsets[Vec::size];
+        alignas (64) int frameOffsets[Vec::size];
+
+        for (int i = 0; i < Vec::size; i++) {
+            rowOffsets[i] = phase[i] * PaddedTaps;
+            frameOffsets[i] = ((index[i] + firstTap) & mask) * stride + lane;
+        }
+
+        const SampleType* memory = delayLine.getFrame(0);
+        Vec sum = Vec::broadcast(0);
+
+        for (int k = 0; k < PaddedTaps; k++) {
+            const Vec weight = Vec::gatherFloat(coefficients + k, rowOffsets);
+            const Vec nextWeight = Vec::gatherFloat(coefficients + PaddedTaps + k, rowOffsets);
+
+            sum = sum + (weight + blend * (nextWeight - weight)) * Vec::gather(memory + k * stride, frameOffsets);
+        }
+
+        return sum;
+    }
+};
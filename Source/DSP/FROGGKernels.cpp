@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    The DSP kernels built for several instruction sets, and the choice of the
+    best one for the CPU at run time.
+
+  ==============================================================================
+*/
+
+#include "FROGGKernelsImpl.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+ #define FROGG_X86 1
+
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+//==============================================================================
+// Defined in the translation units built for each instruction set, nullptr when the build
+// doesn't have the compiler flags for it:
+const FROGGKernels* FROGGGetAVX2Kernels();
+const FROGGKernels* FROGGGetAVX512Kernels();
+
+//==============================================================================
+namespace
+{
+    // Portable loops on any CPU, and the baseline registers this file is compiled for:
+    constexpr FROGGKernels genericKernels = makeKernels<RegisterList<FROGGVecFallback<float, 4>>, RegisterList<FROGGVecFallback<double, 2>>>(
+        FROGGInstructionSet::generic, "generic");
+
+   #if FROGG_SIMD_SSE2 || FROGG_SIMD_NEON
+    constexpr FROGGKernels baselineKernels = makeKernels<RegisterList<FROGGFloatVec>, RegisterList<FROGGDoubleVec>>(
+       #if FROGG_SIMD_SSE2
+        FROGGInstructionSet::sse2, "sse2");
+       #else
+        FROGGInstructionSet::neon, "neon");
+       #endif
+   #endif
+
+    const char* const instructionSetNames[] = { "generic", "sse2", "avx2", "avx512", "neon" };
+
+    //==============================================================================
+    // Instruction sets the CPU and the operating system support beyond the baseline:
+    struct CPUFeatures
+    {
+        bool avx2 = false;      // AVX, AVX2 and FMA, with the YMM state saved by the OS
+        bool avx512 = false;    // AVX2 and AVX-512F, with the ZMM state saved by the OS
+    };
+
+   #if FROGG_X86
+    void cpuid (unsigned int leaf, unsigned int subleaf, unsigned int registers[4])
+    {
+       #if defined (_MSC_VER)
+        int values[4];
+        __cpuidex(values, (int) leaf, (int) subleaf);
+
+        for (int i = 0; i < 4; i++) {
+            registers[i] = (unsigned int) values[i];
+        }
+       #else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+       #endif
+    }
+
+    // Register state the operating system saves on a context switch (XCR0):
+    unsigned long long getEnabledStates()
+    {
+       #if defined (_MSC_VER)
+        return _xgetbv(0);
+       #else
+        unsigned int low, high;
+        __asm__ volatile ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+        return ((unsigned long long) high << 32) | low;
+       #endif
+    }
+   #endif
+
+    CPUFeatures detectFeatures()
+    {
+        CPUFeatures features;
+
+       #if FROGG_X86
+        unsigned int leaf0[4], leaf1[4], leaf7[4] = {};
+        cpuid(0, 0, leaf0);
+        cpuid(1, 0, leaf1);
+
+        if (leaf0[0] >= 7) {
+            cpuid(7, 0, leaf7);
+        }
+
+        const bool hasOSXSave = (leaf1[2] & (1u << 27)) != 0;
+        const bool hasAVX = (leaf1[2] & (1u << 28)) != 0;
+        const bool hasFMA = (leaf1[2] & (1u << 12)) != 0;
+        const bool hasAVX2 = (leaf7[1] & (1u << 5)) != 0;
+        const bool hasAVX512F = (leaf7[1] & (1u << 16)) != 0;
+
+        // SSE and AVX state, plus the opmask and both halves of the upper ZMM registers:
+        const unsigned long long states = hasOSXSave ? getEnabledStates() : 0;
+        const bool savesYMM = (states & 0x6) == 0x6;
+        const bool savesZMM = (states & 0xe6) == 0xe6;
+
+        features.avx2 = hasAVX && hasAVX2 && hasFMA && savesYMM;
+        features.avx512 = features.avx2 && hasAVX512F && savesZMM;
+       #endif
+
+        return features;
+    }
+
+    const CPUFeatures& getFeatures()
+    {
+        static const CPUFeatures features = detectFeatures();
+        return features;
+    }
+
+    //==============================================================================
+    // Best variant, or the one FROGG_INSTRUCTION_SET names if the CPU runs it:
+    const FROGGKernels* selectKernels()
+    {
+        FROGGInstructionSet forced;
+
+        if (const char* name = std::getenv("FROGG_INSTRUCTION_SET")) {
+            if (FROGGGetInstructionSet(name, forced)) {
+                if (const FROGGKernels* kernels = FROGGGetKernels(forced)) {
+                    return kernels;
+                }
+            }
+        }
+
+        for (auto instructionSet : { FROGGInstructionSet::avx512, FROGGInstructionSet::avx2, FROGGInstructionSet::sse2, FROGGInstructionSet::neon }) {
+            if (const FROGGKernels* kernels = FROGGGetKernels(instructionSet)) {
+                return kernels;
+            }
+        }
+
+        return &genericKernels;
+    }
+
+    std::atomic<const FROGGKernels*> forcedKernels { nullptr };
+}
+
+//==============================================================================
+const FROGGKernels& FROGGGetKernels()
+{
+    if (const FROGGKernels* kernels = forcedKernels.load(std::memory_order_acquire)) {
+        return *kernels;
+    }
+
+    static const FROGGKernels* const selectedKernels = selectKernels();
+    return *selectedKernels;
+}
+
+const FROGGKernels* FROGGGetKernels (FROGGInstructionSet instructionSet)
+{
+    switch (instructionSet) {
+        case FROGGInstructionSet::generic:
+            return &genericKernels;
+
+       #if FROGG_SIMD_SSE2
+        case FROGGInstructionSet::sse2:
+            return &baselineKernels;
+       #elif FROGG_SIMD_NEON
+        case FROGGInstructionSet::neon:
+            return &baselineKernels;
+       #endif
+
+        // The wider sets only when the CPU runs them, their code is never touched otherwise:
+        case FROGGInstructionSet::avx2:
+            return getFeatures().avx2 ? FROGGGetAVX2Kernels() : nullptr;
+
+        case FROGGInstructionSet::avx512:
+            return getFeatures().avx512 ? FROGGGetAVX512Kernels() : nullptr;
+
+        default:
+            return nullptr;
+    }
+}
+
+bool FROGGForceInstructionSet (FROGGInstructionSet instructionSet)
+{
+    const FROGGKernels* kernels = FROGGGetKernels(instructionSet);
+
+    if (kernels == nullptr)
+        return false;
+
+    forcedKernels.store(kernels, std::memory_order_release);
+    return true;
+}
+
+bool FROGGGetInstructionSet (const char* name, FROGGInstructionSet& instructionSet)
+{
+    for (int i = 0; i < (int) (sizeof (instructionSetNames) / sizeof (instructionSetNames[0])); i++) {
+        if (std::strcmp(name, instructionSetNames[i]) == 0) {
+            instructionSet = (FROGGInstructionSet) i;
+            return true;
+        }
+    }
+
+    return false;
+}
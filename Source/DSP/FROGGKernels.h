@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    The DSP kernels built for several instruction sets, and the choice of the
+    best one for the CPU at run time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+#include "FROGGDelayLine.h"
+
+#include <type_traits>
+
+//==============================================================================
+// Instruction sets the kernels are built for:
+enum class FROGGInstructionSet
+{
+    generic,    // Plain C++ loops, any CPU
+    sse2,       // x86 baseline
+    avx2,       // x86 with AVX2 and FMA
+    avx512,     // x86 with AVX-512F
+    neon        // ARM baseline
+};
+
+//==============================================================================
+/**
+    The delay and LFO kernels of one instruction set.
+
+    Every variant lives in its own translation unit, compiled with the flags of
+    its instruction set (FROGGKernelsAVX2.cpp, FROGGKernelsAVX512.cpp; the
+    generic and baseline ones in FROGGKernels.cpp), and is only called on a CPU
+    that runs it. The delay kernel takes registers of any width the set has, a
+    delay line is laid out for one of them (see getRegisterSize): a stereo bus
+    stays on the narrow registers, where a wider one would only carry padding,
+    while surround busses fill the wide ones.
+
+    The variants compute the same thing, but a set with fused multiply-adds may
+    round differently in the last bit.
+*/
+struct FROGGKernels
+{
+    FROGGInstructionSet instructionSet;
+    const char* name;
+
+    // Widest register in lanes of each sample type:
+    int maxFloatLanes;
+    int maxDoubleLanes;
+
+    // FROGGProcessDelayChannels on registers of registerSize lanes, a width returned by getRegisterSize:
+    void (*processDelayFloat) (int registerSize, FROGGDelayLine<float>& delayLine, float* feedbackState, float* const* channels,
+                               int sampleStride, int numChannels, const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps);
+    void (*processDelayDouble) (int registerSize, FROGGDelayLine<double>& delayLine, double* feedbackState, double* const* channels,
+                                int sampleStride, int numChannels, const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps);
+
+    // output[i] = FROGGLFO::sinCycles (phases[i] + offset.at (i)), output may be phases:
+    void (*sinCycles) (float* output, const float* phases, FROGGRamp offset, int numSamples);
+
+    //==============================================================================
+    // Narrowest register of the set holding numChannels lanes of SampleType, or its widest.
+    // The delay line frames are padded to a multiple of it:
+    template <typename SampleType>
+    int getRegisterSize (int numChannels) const
+    {
+        const int maxLanes = std::is_same_v<SampleType, double> ? maxDoubleLanes : maxFloatLanes;
+        int registerSize = (int) (16 / sizeof (SampleType));
+
+        while (registerSize < numChannels && registerSize < maxLanes) {
+            registerSize *= 2;
+        }
+
+        return registerSize;
+    }
+
+    template <typename SampleType>
+    void processDelay (int registerSize, FROGGDelayLine<SampleType>& delayLine, SampleType* feedbackState, SampleType* const* channels,
+                       int sampleStride, int numChannels, const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps) const
+    {
+        if constexpr (std::is_same_v<SampleType, double>) {
+            processDelayDouble(registerSize, delayLine, feedbackState, channels, sampleStride, numChannels, lfo, numSamples, ramps);
+        }
+        else {
+            processDelayFloat(registerSize, delayLine, feedbackState, channels, sampleStride, numChannels, lfo, numSamples, ramps);
+        }
+    }
+};
+
+//==============================================================================
+// Kernels of the best instruction set this build and CPU support, chosen on the first call.
+// The environment variable FROGG_INSTRUCTION_SET (generic, sse2, avx2, avx512 or neon)
+// picks another one the CPU supports, for testing or comparing the variants:
+const FROGGKernels& FROGGGetKernels();
+
+// Kernels of one instruction set, nullptr when this build or this CPU lacks it:
+const FROGGKernels* FROGGGetKernels (FROGGInstructionSet instructionSet);
+
+// Makes FROGGGetKernels return the kernels of instructionSet from now on, false (and no change)
+// when they are not available. Delay lines prepared before keep their layout: call it before
+// prepareToPlay, from the message thread:
+bool FROGGForceInstructionSet (FROGGInstructionSet instructionSet);
+
+// Instruction set of a name as in FROGGKernels::name, false if there is none:
+bool FROGGGetInstructionSet (const char* name, FROGGInstructionSet& instructionSet);
@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    The DSP kernels for x86 CPUs with AVX2 and FMA.
+
+    Built with the AVX2 compiler flag scheme of the project (-mavx2 -mfma,
+    /arch:AVX2), and only called once the CPU has been checked for them.
+
+  ==============================================================================
+*/
+
+#include "FROGGKernels.h"
+
+#if defined (__AVX2__)
+ #include "FROGGKernelsImpl.h"
+
+namespace
+{
+    // 128-bit registers for stereo and quad, 256-bit ones for wider busses:
+    constexpr FROGGKernels avx2Kernels = makeKernels<RegisterList<FROGGVecSSE2, FROGGVecAVX2>, RegisterList<FROGGVecSSE2Double, FROGGVecAVX2Double>>(
+        FROGGInstructionSet::avx2, "avx2");
+}
+
+const FROGGKernels* FROGGGetAVX2Kernels()
+{
+    return &avx2Kernels;
+}
+#else
+const FROGGKernels* FROGGGetAVX2Kernels()
+{
+    // Built without the flags, the dispatch stays on the baseline:
+    return nullptr;
+}
+#endif
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    The DSP kernels for x86 CPUs with AVX-512F.
+
+    Built with the AVX512 compiler flag scheme of the project (-mavx512f
+    -mavx2 -mfma, /arch:AVX512), and only called once the CPU has been
+    checked for them.
+
+  ==============================================================================
+*/
+
+#include "FROGGKernels.h"
+
+#if defined (__AVX512F__) && defined (__AVX2__)
+ #include "FROGGKernelsImpl.h"
+
+namespace
+{
+    // 128-bit registers for stereo and quad, 256-bit ones up to 7.1, 512-bit ones for 9.1.6:
+    constexpr FROGGKernels avx512Kernels = makeKernels<RegisterList<FROGGVecSSE2, FROGGVecAVX2, FROGGVecAVX512>,
+                                                       RegisterList<FROGGVecSSE2Double, FROGGVecAVX2Double, FROGGVecAVX512Double>>(
+        FROGGInstructionSet::avx512, "avx512");
+}
+
+const FROGGKernels* FROGGGetAVX512Kernels()
+{
+    return &avx512Kernels;
+}
+#else
+const FROGGKernels* FROGGGetAVX512Kernels()
+{
+    // Built without the flags, the dispatch stays on AVX2 at most:
+    return nullptr;
+}
+#endif
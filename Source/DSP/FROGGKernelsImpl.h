@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Builds the FROGGKernels of one instruction set. Included once by each
+    translation unit compiled for an instruction set, never elsewhere.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGDelayKernel.h"
+#include "FROGGKernels.h"
+#include "FROGGLFO.h"
+#include "FROGGSIMD.h"
+
+//==============================================================================
+// Local to the including translation unit, like the register wrappers:
+namespace
+{
+    // Registers of one sample type, narrowest first:
+    template <typename... Vecs>
+    struct RegisterList {};
+
+    // FROGGProcessDelayChannels on the register of the list that is registerSize lanes wide:
+    template <typename Vec, typename... Wider>
+    void processDelayOn (RegisterList<Vec, Wider...>, int registerSize, FROGGDelayLine<typename Vec::SampleType>& delayLine,
+                         typename Vec::SampleType* feedbackState, typename Vec::SampleType* const* channels, int sampleStride, int numChannels,
+                         const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps)
+    {
+        if constexpr (sizeof... (Wider) > 0) {
+            if (registerSize > Vec::size) {
+                processDelayOn(RegisterList<Wider...>(), registerSize, delayLine, feedbackState, channels, sampleStride, numChannels, lfo, numSamples, ramps);
+                return;
+            }
+        }
+
+        FROGGProcessDelayChannels<Vec>(delayLine, feedbackState, channels, sampleStride, numChannels, lfo, numSamples, ramps);
+    }
+
+    // Plain loop, vectorised by the compiler for the instruction set of the translation unit:
+    void sinCyclesOf (float* output, const float* phases, FROGGRamp offset, int numSamples)
+    {
+        for (int i = 0; i < numSamples; i++) {
+            output[i] = FROGGLFO::sinCycles(phases[i] + offset.at(i));
+        }
+    }
+
+    // Kernel entry point of one sample type:
+    template <typename Registers, typename SampleType>
+    void processDelayWith (int registerSize, FROGGDelayLine<SampleType>& delayLine, SampleType* feedbackState, SampleType* const* channels,
+                           int sampleStride, int numChannels, const float* const* lfo, int numSamples, const FROGGBlockParameters& ramps)
+    {
+        processDelayOn(Registers(), registerSize, delayLine, feedbackState, channels, sampleStride, numChannels, lfo, numSamples, ramps);
+    }
+
+    // Widest register of a list:
+    template <typename... Vecs>
+    constexpr int getMaxLanes (RegisterList<Vecs...>)
+    {
+        int maxLanes = 0;
+        ((maxLanes = Vecs::size > maxLanes ? Vecs::size : maxLanes), ...);
+        return maxLanes;
+    }
+
+    // The kernels on the given float and double registers, nothing runs until they are called:
+    template <typename FloatRegisters, typename DoubleRegisters>
+    constexpr FROGGKernels makeKernels (FROGGInstructionSet instructionSet, const char* name)
+    {
+        return { instructionSet, name, getMaxLanes(FloatRegisters()), getMaxLanes(DoubleRegisters()),
+                 processDelayWith<FloatRegisters, float>,
+                 processDelayWith<DoubleRegisters, double>,
+                 sinCyclesOf };
+    }
+}
@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    Block-rate sine LFO that modulates the delay read heads.
+
+  ==============================================================================
+*/
+
+#include "FROGGLFO.h"
+#include "FROGGKernels.h"
+
+#include <cmath>
+
+//==============================================================================
+namespace
+{
+    // Phase after numSamples samples of the ramp, starting at its sample firstSample, within a block:
+    float stepPhase (float phase, int numSamples, const FROGGRamp& phaseIncrement, int firstSample)
+    {
+        const float n = (float) numSamples;
+        const float advanced = phase + n * phaseIncrement.at(firstSample) + 0.5f * n * (n - 1.0f) * phaseIncrement.step;
+
+        // Never negative, truncation is a floor:
+        return advanced - (float) (int) advanced;
+    }
+
+    // Phase numSamples samples before the start of the ramp, the ramp carried on backwards:
+    float stepPhaseBack (float phase, int numSamples, const FROGGRamp& phaseIncrement)
+    {
+        const float n = (float) numSamples;
+        const float receded = phase - n * phaseIncrement.start + 0.5f * n * (n + 1.0f) * phaseIncrement.step;
+
+        return receded - std::floor(receded);
+    }
+
+    // Phase after numSamples samples of the ramp, starting at its sample firstSample. The sum of
+    // the ramp is taken in double so long idle stretches keep their precision:
+    float advancePhase (float phase, int numSamples, const FROGGRamp& phaseIncrement, int firstSample)
+    {
+        const double n = (double) numSamples;
+        const double cycles = n * phaseIncrement.at(firstSample) + 0.5 * n * (n - 1.0) * phaseIncrement.step;
+
+        const double advanced = (double) phase + cycles;
+        return (float) (advanced - std::floor(advanced));
+    }
+}
+
+//==============================================================================
+FROGGLFO::FROGGLFO()
+{
+    reset();
+    setNumChannels(2);
+    setNumVoices(1);
+    setControlInterval(1);
+}
+
+void FROGGLFO::reset (float phase, long long samplePosition)
+{
+    mPhase = phase;
+    mSamplePosition = samplePosition;
+    mIsOnTimeline = false;
+
+    // No control point reached yet, the first one is found back from the phase:
+    mControlPosition = -1;
+    mControlPhase = phase;
+}
+
+void FROGGLFO::setTimeline (double phase, long long samplePosition, double phaseIncrement)
+{
+    mIsOnTimeline = true;
+    mTimelinePhase = phase - std::floor(phase);
+    mTimelinePosition = samplePosition;
+    mTimelineIncrement = phaseIncrement;
+
+    mSamplePosition = samplePosition;
+    mPhase = getTimelinePhase(samplePosition);
+    mControlPosition = -1;
+    mControlPhase = mPhase;
+}
+
+void FROGGLFO::advance (int numSamples, const FROGGRamp& phaseIncrement)
+{
+    mSamplePosition += numSamples;
+    mPhase = mIsOnTimeline ? getTimelinePhase(mSamplePosition) : advancePhase(mPhase, numSamples, phaseIncrement, 0);
+}
+
+void FROGGLFO::setNumChannels (int numChannels)
+{
+    mNumChannels = numChannels < 1 ? 1 : (numChannels > FROGGMaxChannels ? FROGGMaxChannels : numChannels);
+
+    for (int c = 0; c < FROGGMaxChannels; c++) {
+        mChannelSpread[c] = mNumChannels > 1 ? (float) c / (float) (mNumChannels - 1) : 0.0f;
+    }
+}
+
+void FROGGLFO::setNumVoices (int numVoices)
+{
+    mNumVoices = numVoices < 1 ? 1 : (numVoices > FROGGMaxVoices ? FROGGMaxVoices : numVoices);
+
+    for (int v = 0; v < FROGGMaxVoices; v++) {
+        mVoicePhaseOffsets[v] = (float) v / (float) mNumVoices;
+    }
+}
+
+void FROGGLFO::process (float* const* outputs, int numSamples, const FROGGRamp& phaseIncrement, const FROGGRamp& phaseOffset)
+{
+    if (mControlInterval > 1) {
+        float* pieceOutputs[FROGGMaxVoices * FROGGMaxChannels];
+
+        // At most FROGGChunkSize samples at a time, so the control points fit on the stack:
+        for (int pieceStart = 0; pieceStart < numSamples; pieceStart += FROGGChunkSize) {
+            for (int j = 0; j < mNumVoices * mNumChannels; j++) {
+                pieceOutputs[j] = outputs[j] + pieceStart;
+            }
+
+            processAtControlRate(pieceOutputs, numSamples - pieceStart < FROGGChunkSize ? numSamples - pieceStart : FROGGChunkSize,
+                                 { phaseIncrement.at(pieceStart), phaseIncrement.step }, { phaseOffset.at(pieceStart), phaseOffset.step });
+        }
+
+        return;
+    }
+
+    const FROGGKernels& kernels = FROGGGetKernels();
+    float* phases = outputs[0];
+
+    // Phase accumulation is the only serial part, store the phases of the first channel first.
+    // On a timeline every phase comes from the sample's position instead:
+    if (mIsOnTimeline) {
+        for (int i = 0; i < numSamples; i++) {
+            phases[i] = getTimelinePhase(mSamplePosition + i);
+        }
+
+        mPhase = getTimelinePhase(mSamplePosition + numSamples);
+    }
+    else {
+        for (int i = 0; i < numSamples; i++) {
+            phases[i] = mPhase;
+
+            mPhase += phaseIncrement.at(i);
+
+            if (mPhase > 1) {
+                mPhase -= 1;
+            }
+        }
+    }
+
+    // Every sample is a control point:
+    mSamplePosition += numSamples;
+    mControlPosition = mSamplePosition;
+    mControlPhase = mPhase;
+
+    // Then evaluate every other channel and voice without branches, shifted by its own offsets:
+    for (int v = 0; v < mNumVoices; v++) {
+        const float voiceOffset = mVoicePhaseOffsets[v];
+
+        for (int c = (v == 0 ? 1 : 0); c < mNumChannels; c++) {
+            const FROGGRamp channelOffset { phaseOffset.start * mChannelSpread[c] + voiceOffset, phaseOffset.step * mChannelSpread[c] };
+            float* output = outputs[v * mNumChannels + c];
+
+            kernels.sinCycles(output, phases, channelOffset, numSamples);
+        }
+    }
+
+    // The first channel of the first voice last, in place over the phases it was reading:
+    kernels.sinCycles(phases, phases, FROGGRamp(), numSamples);
+}
+
+void FROGGLFO::processAtControlRate (float* const* outputs, int numSamples, const FROGGRamp& phaseIncrement, const FROGGRamp& phaseOffset)
+{
+    const int interval = mControlInterval;
+
+    // The block starts samplesSincePoint samples after a control point (also before a timeline's zero),
+    // control point k sits at sample firstPoint + k * interval and the one after the last lies past the block:
+    const int samplesSincePoint = (int) (((mSamplePosition % interval) + interval) % interval);
+    const int firstPoint = -samplesSincePoint;
+    const int numPoints = (numSamples - 1 - firstPoint) / interval + 2;
+
+    alignas (64) float phases[maxControlPoints];
+    alignas (64) float values[maxControlPoints];
+
+    if (mIsOnTimeline) {
+        // Every control point from its position:
+        for (int k = 0; k < numPoints; k++) {
+            phases[k] = getTimelinePhase(mSamplePosition + firstPoint + k * interval);
+        }
+    }
+    else {
+        // The first control point is the last one of the block before, unless the phase was moved since:
+        float phase = mControlPosition == mSamplePosition - samplesSincePoint ? mControlPhase
+                                                                              : stepPhaseBack(mPhase, samplesSincePoint, phaseIncrement);
+
+        // Phases of the control points, jumping from one to the next:
+        for (int k = 0; k < numPoints; k++) {
+            phases[k] = phase;
+            phase = stepPhase(phase, interval, phaseIncrement, firstPoint + k * interval);
+        }
+    }
+
+    // The last control point within or at the end of the block, and the phase the block ends on:
+    const int lastPoint = (numSamples - firstPoint) / interval;
+    const int lastPointSample = firstPoint + lastPoint * interval;
+
+    mControlPhase = phases[lastPoint];
+    mControlPosition = mSamplePosition + lastPointSample;
+    mPhase = mIsOnTimeline ? getTimelinePhase(mSamplePosition + numSamples)
+                           : stepPhase(mControlPhase, numSamples - lastPointSample, phaseIncrement, lastPointSample);
+    mSamplePosition += numSamples;
+
+    const FROGGKernels& kernels = FROGGGetKernels();
+    const float step = 1.0f / (float) interval;
+
+    for (int v = 0; v < mNumVoices; v++) {
+        for (int c = 0; c < mNumChannels; c++) {
+            const FROGGRamp channelOffset { phaseOffset.start * mChannelSpread[c] + mVoicePhaseOffsets[v], phaseOffset.step * mChannelSpread[c] };
+
+            // The sine at every control point:
+            kernels.sinCycles(values, phases, { channelOffset.at(firstPoint), channelOffset.step * (float) interval }, numPoints);
+
+            // Straight lines between them:
+            float* output = outputs[v * mNumChannels + c];
+
+            for (int k = 0; k < numPoints - 1; k++) {
+                const int point = firstPoint + k * interval;
+                const int segmentStart = point > 0 ? point : 0;
+                const int segmentEnd = point + interval < numSamples ? point + interval : numSamples;
+                const float start = values[k];
+                const float slope = (values[k + 1] - start) * step;
+
+                for (int i = segmentStart; i < segmentEnd; i++) {
+                    output[i] = start + slope * (float) (i - point);
+                }
+            }
+        }
+    }
+}
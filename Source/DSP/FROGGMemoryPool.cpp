@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    Process-wide pool of aligned blocks for the delay memory of every instance.
+
+  ==============================================================================
+*/
+
+#include "FROGGMemoryPool.h"
+
+#include <new>
+
+//==============================================================================
+namespace
+{
+    float* allocateAligned (size_t numFloats)
+    {
+        return static_cast<float*>(::operator new(numFloats * sizeof (float), std::align_val_t(FROGGMemoryPool::alignment)));
+    }
+
+    void freeAligned (float* data)
+    {
+        ::operator delete(data, std::align_val_t(FROGGMemoryPool::alignment));
+    }
+}
+
+//==============================================================================
+FROGGMemoryPool::Block::~Block()
+{
+    release();
+}
+
+FROGGMemoryPool::Block::Block (Block&& other) noexcept
+    : mData(other.mData),
+      mCapacity(other.mCapacity)
+{
+    other.mData = nullptr;
+    other.mCapacity = 0;
+}
+
+FROGGMemoryPool::Block& FROGGMemoryPool::Block::operator= (Block&& other) noexcept
+{
+    if (this != &other) {
+        release();
+
+        mData = other.mData;
+        mCapacity = other.mCapacity;
+        other.mData = nullptr;
+        other.mCapacity = 0;
+    }
+
+    return *this;
+}
+
+void FROGGMemoryPool::Block::release()
+{
+    if (mData != nullptr) {
+        FROGGMemoryPool::getInstance().recycle(mData, mCapacity);
+        mData = nullptr;
+        mCapacity = 0;
+    }
+}
+
+//==============================================================================
+FROGGMemoryPool& FROGGMemoryPool::getInstance()
+{
+    static FROGGMemoryPool instance;
+    return instance;
+}
+
+FROGGMemoryPool::~FROGGMemoryPool()
+{
+    trim();
+}
+
+FROGGMemoryPool::Block FROGGMemoryPool::acquire (size_t numFloats)
+{
+    if (numFloats == 0) {
+        return {};
+    }
+
+    // Whole cache lines, so the block can be handed out again for any size up to them:
+    const size_t floatsPerLine = alignment / sizeof (float);
+    const size_t capacity = (numFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        // Best fit among the cached blocks, skipping any more than twice the size asked for:
+        size_t bestIndex = mCachedBlocks.size();
+
+        for (size_t i = 0; i < mCachedBlocks.size(); i++) {
+            const size_t cachedCapacity = mCachedBlocks[i].capacity;
+
+            if (cachedCapacity >= numFloats && cachedCapacity <= numFloats * 2
+                && (bestIndex == mCachedBlocks.size() || cachedCapacity < mCachedBlocks[bestIndex].capacity)) {
+                bestIndex = i;
+            }
+        }
+
+        if (bestIndex < mCachedBlocks.size()) {
+            const CachedBlock cached = mCachedBlocks[bestIndex];
+            mCachedBlocks.erase(mCachedBlocks.begin() + (std::ptrdiff_t) bestIndex);
+            mCachedBytes -= cached.capacity * sizeof (float);
+            return Block(cached.data, cached.capacity);
+        }
+
+        mAllocatedBytes += capacity * sizeof (float);
+    }
+
+    return Block(allocateAligned(capacity), capacity);
+}
+
+void FROGGMemoryPool::setMaxCachedBytes (size_t maxCachedBytes)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mMaxCachedBytes = maxCachedBytes;
+    trimTo(mMaxCachedBytes);
+}
+
+void FROGGMemoryPool::trim()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    trimTo(0);
+}
+
+size_t FROGGMemoryPool::getCachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCachedBytes;
+}
+
+size_t FROGGMemoryPool::getAllocatedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mAllocatedBytes;
+}
+
+//==============================================================================
+void FROGGMemoryPool::recycle (float* data, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mCachedBlocks.push_back({ data, capacity });
+    mCachedBytes += capacity * sizeof (float);
+
+    trimTo(mMaxCachedBytes);
+}
+
+void FROGGMemoryPool::trimTo (size_t maxCachedBytes)
+{
+    // Oldest blocks go first, the recently released ones are the likeliest to be asked for again:
+    size_t numFreed = 0;
+
+    while (mCachedBytes > maxCachedBytes && numFreed < mCachedBlocks.size()) {
+        const CachedBlock& cached = mCachedBlocks[numFreed++];
+        freeAligned(cached.data);
+        mCachedBytes -= cached.capacity * sizeof (float);
+        mAllocatedBytes -= cached.capacity * sizeof (float);
+    }
+
+    mCachedBlocks.erase(mCachedBlocks.begin(), mCachedBlocks.begin() + (std::ptrdiff_t) numFreed);
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    Process-wide pool of aligned blocks for the delay memory of every instance.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+    Aligned float memory shared by all the plugin instances of a process.
+
+    Released blocks are kept, up to a byte limit, and handed to the next
+    instance that asks for a block they can hold, so sessions with hundreds of
+    instances, or hosts that prepare an instance again and again, reuse memory
+    instead of going back to the system allocator. Blocks are 64 byte aligned
+    (a cache line, and every register width the kernels use).
+
+    acquire and release lock a mutex and may allocate: call them from prepare /
+    release, never from the audio thread.
+*/
+class FROGGMemoryPool
+{
+public:
+    //==============================================================================
+    static constexpr size_t alignment = 64;
+
+    //==============================================================================
+    // Move-only handle to a block, gives the memory back to the pool when destroyed:
+    class Block
+    {
+    public:
+        Block() = default;
+        ~Block();
+
+        Block (Block&& other) noexcept;
+        Block& operator= (Block&& other) noexcept;
+
+        Block (const Block&) = delete;
+        Block& operator= (const Block&) = delete;
+
+        float* get() const              { return mData; }
+        size_t getCapacity() const      { return mCapacity; }
+
+        // Returns the memory to the pool now, the handle is empty afterwards:
+        void release();
+
+    private:
+        friend class FROGGMemoryPool;
+        Block (float* data, size_t capacity) : mData(data), mCapacity(capacity) {}
+
+        float* mData = nullptr;
+        size_t mCapacity = 0;
+    };
+
+    //==============================================================================
+    static FROGGMemoryPool& getInstance();
+
+    // A block of at least numFloats floats, reused when a cached one fits without
+    // wasting more than half of it. The contents are undefined:
+    Block acquire (size_t numFloats);
+
+    // Most memory kept for reuse once released, anything above is freed:
+    void setMaxCachedBytes (size_t maxCachedBytes);
+
+    // Frees every cached block:
+    void trim();
+
+    size_t getCachedBytes() const;
+    size_t getAllocatedBytes() const;
+
+    ~FROGGMemoryPool();
+
+private:
+    //==============================================================================
+    FROGGMemoryPool() = default;
+
+    void recycle (float* data, size_t capacity);
+    void trimTo (size_t maxCachedBytes);
+
+    struct CachedBlock
+    {
+        float* data;
+        size_t capacity;
+    };
+
+    mutable std::mutex mLock;
+    std::vector<CachedBlock> mCachedBlocks;
+    size_t mCachedBytes = 0;
+    size_t mAllocatedBytes = 0;
+    size_t mMaxCachedBytes = 64 * 1024 * 1024;
+};
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    Reads the parameters once per block and turns them into smoothed ramps
+    for the DSP kernels.
+
+  ==============================================================================
+*/
+
+#include "FROGGParameterStage.h"
+
+#include <initializer_list>
+
+//==============================================================================
+namespace
+{
+    // Advances a smoother by numSamples and returns the straight line it followed:
+    FROGGRamp nextRamp (FROGGSmoothedValue& smoother, int numSamples)
+    {
+        FROGGRamp ramp;
+        ramp.start = smoother.getCurrentValue();
+
+        if (smoother.isSmoothing()) {
+            ramp.step = (smoother.skip(numSamples) - ramp.start) / (float) numSamples;
+        }
+
+        return ramp;
+    }
+}
+
+//==============================================================================
+void FROGGParameterStage::prepare (double sampleRate, const Snapshot& snapshot)
+{
+    mSampleRate = sampleRate;
+    mWetMuted = false;
+
+    for (auto* smoother : { &mPhaseIncrement, &mPhaseOffset, &mDelayCentre, &mDelayDepth, &mFeedback, &mDryWet }) {
+        smoother->reset(sampleRate, smoothingTimeSeconds);
+    }
+
+    setTargets(snapshot, true);
+}
+
+void FROGGParameterStage::update (const Snapshot& snapshot)
+{
+    setTargets(snapshot, false);
+}
+
+void FROGGParameterStage::setTargets (const Snapshot& snapshot, bool jumpToTargets)
+{
+    // Same mapping as jmap(lfo * depth, -1, 1, min, max) * sampleRate, split into centre and excursion:
+    const FROGGDelayRange& range = snapshot.type == 0 ? FROGGChorusRange : FROGGFlangerRange;
+    const float delayCentre = (float) (mSampleRate * (range.minSeconds + range.maxSeconds) * 0.5);
+    const float delayDepth = (float) (mSampleRate * (range.maxSeconds - range.minSeconds) * 0.5) * snapshot.depth;
+
+    const float phaseIncrement = (float) (snapshot.rate / mSampleRate);
+
+    auto set = [jumpToTargets] (FROGGSmoothedValue& smoother, float value)
+    {
+        if (jumpToTargets) {
+            smoother.setCurrentAndTargetValue(value);
+        }
+        else {
+            smoother.setTargetValue(value);
+        }
+    };
+
+    set(mPhaseIncrement, phaseIncrement);
+    set(mPhaseOffset, snapshot.phaseOffset);
+    set(mDelayCentre, delayCentre);
+    set(mDelayDepth, delayDepth);
+    set(mFeedback, snapshot.feedback);
+    set(mDryWet, mWetMuted ? 0.0f : snapshot.dryWet);
+
+    mNumVoices = snapshot.voices;
+
+    // The tier sets the control rate, and the interpolator unless one is chosen:
+    const FROGGQualityTier& tier = FROGGQualityTiers[snapshot.quality < 0 ? 0 : snapshot.quality < FROGGNumQualityTiers ? snapshot.quality : FROGGNumQualityTiers - 1];
+    mControlInterval = tier.controlInterval;
+    mInterpolation = snapshot.interpolation == autoInterpolation ? tier.interpolation : (FROGGInterpolation) snapshot.interpolation;
+}
+
+void FROGGParameterStage::setWetMuted (bool shouldBeMuted)
+{
+    mWetMuted = shouldBeMuted;
+
+    // Starts right away, unmuting takes the parameter value on the next update:
+    if (mWetMuted) {
+        mDryWet.setTargetValue(0.0f);
+    }
+}
+
+FROGGBlockParameters FROGGParameterStage::getNextRamps (int numSamples)
+{
+    FROGGBlockParameters ramps;
+
+    ramps.phaseIncrement = nextRamp(mPhaseIncrement, numSamples);
+    ramps.phaseOffset = nextRamp(mPhaseOffset, numSamples);
+    ramps.delayCentre = nextRamp(mDelayCentre, numSamples);
+    ramps.delayDepth = nextRamp(mDelayDepth, numSamples);
+    ramps.feedback = nextRamp(mFeedback, numSamples);
+    ramps.dryWet = nextRamp(mDryWet, numSamples);
+    ramps.numVoices = mNumVoices;
+    ramps.controlInterval = mControlInterval;
+    ramps.interpolation = mInterpolation;
+
+    return ramps;
+}
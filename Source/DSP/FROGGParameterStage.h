@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    Reads the parameters once per block and turns them into smoothed ramps
+    for the DSP kernels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+#include "FROGGQuality.h"
+
+//==============================================================================
+/**
+    Linear ramp to a target over a fixed number of samples, the same steps as a
+    linear juce::SmoothedValue.
+*/
+class FROGGSmoothedValue
+{
+public:
+    //==============================================================================
+    // Sets the ramp length and jumps to the target:
+    void reset (double sampleRate, double rampLengthSeconds)
+    {
+        mStepsToTarget = (int) (rampLengthSeconds * sampleRate);
+        setCurrentAndTargetValue(mTarget);
+    }
+
+    void setCurrentAndTargetValue (float value)
+    {
+        mCurrent = mTarget = value;
+        mCountdown = 0;
+    }
+
+    // Starts a new ramp from the current value, unless the target stays the same:
+    void setTargetValue (float value)
+    {
+        if (value == mTarget)
+            return;
+
+        if (mStepsToTarget <= 0) {
+            setCurrentAndTargetValue(value);
+            return;
+        }
+
+        mTarget = value;
+        mCountdown = mStepsToTarget;
+        mStep = (mTarget - mCurrent) / (float) mCountdown;
+    }
+
+    // Moves numSamples along the ramp and returns the value reached:
+    float skip (int numSamples)
+    {
+        if (numSamples >= mCountdown) {
+            setCurrentAndTargetValue(mTarget);
+            return mTarget;
+        }
+
+        mCurrent += mStep * (float) numSamples;
+        mCountdown -= numSamples;
+        return mCurrent;
+    }
+
+    float getCurrentValue() const   { return mCurrent; }
+    float getTargetValue() const    { return mTarget; }
+    bool isSmoothing() const        { return mCountdown > 0; }
+
+private:
+    //==============================================================================
+    float mCurrent = 0.0f;
+    float mTarget = 0.0f;
+    float mStep = 0.0f;
+    int mCountdown = 0;
+    int mStepsToTarget = 0;
+};
+
+//==============================================================================
+/**
+    Parameter stage between the parameter values and the DSP kernels.
+
+    The parameters are read once per block into a Snapshot, the derived coefficients
+    (delay range in samples, LFO phase increment) are computed once per block and
+    every value is smoothed with a linear FROGGSmoothedValue, which also removes
+    the zipper noise of knob moves.
+*/
+class FROGGParameterStage
+{
+public:
+    //==============================================================================
+    // Interpolation index that leaves the interpolator to the quality tier:
+    static constexpr int autoInterpolation = 4;
+
+    // Plain copy of the parameter values for one block:
+    struct Snapshot
+    {
+        float dryWet = 0.5f;
+        float depth = 0.5f;
+        float rate = 10.0f;
+        float phaseOffset = 0.5f;
+        float feedback = 0.5f;
+        int type = 1;
+        int voices = 1;
+        int interpolation = (int) FROGGInterpolation::linear;
+        int quality = FROGGDefaultQualityTier;
+
+        // Processing rate, not smoothed here but read by FROGGCore:
+        int oversamplingFactor = 1;
+        bool rateReduction = false;
+    };
+
+    // Ramp time used for every parameter:
+    static constexpr double smoothingTimeSeconds = 0.05;
+
+    //==============================================================================
+    // Resets the smoothers and jumps straight to the given values:
+    void prepare (double sampleRate, const Snapshot& snapshot);
+
+    // Sets the new targets, call once per block:
+    void update (const Snapshot& snapshot);
+
+    // Returns the ramps for the next numSamples and advances the smoothers:
+    FROGGBlockParameters getNextRamps (int numSamples);
+
+    // Ramps the dry / wet mix down to dry only (true), or back to the parameter value (false),
+    // over smoothingTimeSeconds. Used to crossfade through the dry signal on a program change:
+    void setWetMuted (bool shouldBeMuted);
+
+    // True once the wet signal has been faded out completely:
+    bool isWetMuted() const { return mWetMuted && ! mDryWet.isSmoothing(); }
+
+    // Dry / wet value the smoother has reached:
+    float getDryWet() const { return mDryWet.getCurrentValue(); }
+
+    double getSampleRate() const { return mSampleRate; }
+
+private:
+    //==============================================================================
+    void setTargets (const Snapshot& snapshot, bool jumpToTargets);
+
+    double mSampleRate = 44100.0;
+    int mNumVoices = 1;
+    int mControlInterval = 1;
+    bool mWetMuted = false;
+    FROGGInterpolation mInterpolation = FROGGInterpolation::linear;
+
+    FROGGSmoothedValue mPhaseIncrement;
+    FROGGSmoothedValue mPhaseOffset;
+    FROGGSmoothedValue mDelayCentre;
+    FROGGSmoothedValue mDelayDepth;
+    FROGGSmoothedValue mFeedback;
+    FROGGSmoothedValue mDryWet;
+};
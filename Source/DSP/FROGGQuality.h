@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    Quality tiers trading modulation accuracy, interpolation order and
+    precision for CPU.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+
+//==============================================================================
+/**
+    Settings of one quality tier.
+
+    relativeCost is the processing time against Standard, measured on the delay
+    and LFO kernels for a stereo chorus at 48 kHz, with 1 to 3 voices and no
+    oversampling (x86-64, SSE2). It is a budget figure, the exact ratio moves a
+    little with the voices and the machine: more voices weigh the interpolation
+    order more. Oversampling multiplies every tier by about the factor.
+*/
+struct FROGGQualityTier
+{
+    const char* name;
+    int controlInterval;                // Samples between two evaluations of the LFO, see FROGGLFO
+    FROGGInterpolation interpolation;   // Used while the interpolation parameter is on Auto
+    bool doublePrecision;               // Delay line, feedback and filters in double, also for a float host
+    float relativeCost;
+};
+
+static constexpr FROGGQualityTier FROGGQualityTiers[] =
+{
+    { "Eco",        32, FROGGInterpolation::linear,     false, 0.55f },
+    { "Standard",   8,  FROGGInterpolation::hermite,    false, 1.0f  },
+    { "High",       1,  FROGGInterpolation::lagrange,   false, 1.3f  },
+    { "Ultra",      1,  FROGGInterpolation::sinc,       true,  1.7f  },
+};
+
+static constexpr int FROGGNumQualityTiers = (int) (sizeof (FROGGQualityTiers) / sizeof (FROGGQualityTiers[0]));
+
+// Tier of sessions saved before there were tiers: High evaluates the LFO every sample like
+// the plugin did, so with their interpolator (Linear unless they chose one) they sound the same:
+static constexpr int FROGGLegacyQualityTier = 2;
+
+// Tier of a new instance, the legacy one: together with Linear interpolation it keeps the sound
+// of the plugin, Eco and Standard are a trade-off chosen explicitly:
+static constexpr int FROGGDefaultQualityTier = FROGGLegacyQualityTier;
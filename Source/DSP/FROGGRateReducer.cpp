@@ -0,0 +1,390 @@
+/*
+  ==============================================================================
+
+    Half band decimation and interpolation of the wet path, for sessions
+    running well above the rate the effect needs.
+
+  ==============================================================================
+*/
+
+#include "FROGGRateReducer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+namespace
+{
+    // Stop band attenuation of every stage, below the -90 dBFS silence threshold:
+    constexpr double stopBandDb = 96.0;
+
+    // Zeroth order modified Bessel function, for the Kaiser window:
+    double besselI0 (double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // sums[k] += taps[i] * (first[k + i] + last[k - i]) over numPairs symmetric tap pairs. Four
+    // pairs per pass along the outputs, so the sums are loaded and stored a quarter as often:
+    template <typename SampleType>
+    void addTapPairs (SampleType* sums, int numSums, const SampleType* taps, int numPairs, const SampleType* first, const SampleType* last)
+    {
+        int i = 0;
+
+        for (; i + 4 <= numPairs; i += 4) {
+            const SampleType tap0 = taps[i], tap1 = taps[i + 1], tap2 = taps[i + 2], tap3 = taps[i + 3];
+            const SampleType* first0 = first + i;
+            const SampleType* last0 = last - i;
+
+            for (int k = 0; k < numSums; k++) {
+                sums[k] += tap0 * (first0[k] + last0[k]) + tap1 * (first0[k + 1] + last0[k - 1])
+                         + tap2 * (first0[k + 2] + last0[k - 2]) + tap3 * (first0[k + 3] + last0[k - 3]);
+            }
+        }
+
+        for (; i < numPairs; i++) {
+            for (int k = 0; k < numSums; k++) {
+                sums[k] += taps[i] * (first[k + i] + last[k - i]);
+            }
+        }
+    }
+}
+
+int FROGGGetRateReduction (double sampleRate)
+{
+    int factor = 1;
+
+    while (factor < FROGGMaxRateReduction && sampleRate / (factor * 2) >= FROGGMinReducedRate) {
+        factor *= 2;
+    }
+
+    return factor;
+}
+
+//==============================================================================
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::prepare (double sampleRate, int numChannels, int maxBlockSize, int factor)
+{
+    mNumChannels = numChannels;
+    mMaxBlockSize = maxBlockSize;
+    mFactor = factor;
+    mLatency = 0;
+
+    // One stage per halving, the first at the host rate:
+    mStages.assign((size_t) (factor == 4 ? 2 : factor == 2 ? 1 : 0), Stage());
+
+    const double reducedRate = sampleRate / factor;
+
+    for (size_t s = 0; s < mStages.size(); s++) {
+        Stage& stage = mStages[s];
+
+        // The last stage keeps FROGGReducedPassbandHz, the ones before also keep its transition
+        // band clear of aliases, up to where it stops:
+        const double passbandHz = s + 1 == mStages.size() ? FROGGReducedPassbandHz : reducedRate - FROGGReducedPassbandHz;
+        designStage(stage, sampleRate / (double) (1 << s), passbandHz);
+
+        // Room for the history and the most samples a block brings to the stage, in either direction:
+        stage.lineLength = stage.numTaps + (maxBlockSize >> s) + 2;
+        stage.decimatorLines.assign((size_t) (stage.lineLength * numChannels), 0);
+        stage.interpolatorLines.assign((size_t) (stage.lineLength * numChannels), 0);
+
+        stage.outputLength = (maxBlockSize >> (s + 1)) + 2;
+        stage.output.assign((size_t) (stage.outputLength * numChannels), 0);
+
+        // Each stage delays by its centre tap on the way down and again on the way up, at its input rate:
+        mLatency += (stage.numTaps - 1) / 2 * 2 << s;
+    }
+
+    // The reduced samples are the output of the last stage:
+    mReducedChannels.assign((size_t) numChannels, nullptr);
+
+    if (! mStages.empty()) {
+        Stage& last = mStages.back();
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            mReducedChannels[(size_t) channel] = last.output.data() + channel * last.outputLength;
+        }
+    }
+
+    // A block may end with an incomplete group, and the group before it is still queued:
+    mWetLength = maxBlockSize + 2 * factor;
+    mWet.assign((size_t) (mWetLength * numChannels), 0);
+
+    // Scratch for the polyphase parts of the longest line:
+    const size_t scratchLength = mStages.empty() ? 0 : (size_t) (mStages.front().lineLength / 2 + 1);
+    mEven.assign(scratchLength, 0);
+    mOdd.assign(scratchLength, 0);
+
+    mDryLength = mLatency + maxBlockSize;
+    mDry.assign((size_t) (mDryLength * numChannels), 0);
+
+    reset();
+}
+
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::reset (int groupPosition)
+{
+    for (Stage& stage : mStages) {
+        std::fill(stage.decimatorLines.begin(), stage.decimatorLines.end(), (SampleType) 0);
+        std::fill(stage.interpolatorLines.begin(), stage.interpolatorLines.end(), (SampleType) 0);
+
+        // The first output comes with the second input, so each group of factor host samples
+        // leaves the stages on its last sample:
+        stage.decimatorFill = stage.numTaps - 2;
+    }
+
+    // The group completed on a host sample covers it and the factor - 1 before it, which
+    // the wet output starts behind:
+    std::fill(mWet.begin(), mWet.end(), (SampleType) 0);
+    mNumWet = mFactor - 1;
+
+    std::fill(mDry.begin(), mDry.end(), (SampleType) 0);
+
+    // The silent samples the group already holds go down the stages, and out of the wet queue
+    // as mix would take them:
+    if (groupPosition > 0 && ! mStages.empty()) {
+        const SampleType silence[FROGGMaxRateReduction] = {};
+        const SampleType* input[FROGGMaxChannels];
+
+        for (int channel = 0; channel < mNumChannels; channel++) {
+            input[channel] = silence;
+        }
+
+        decimate(input, 1, mNumChannels, groupPosition % mFactor);
+        mNumWet -= groupPosition % mFactor;
+    }
+}
+
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::release()
+{
+    mStages.clear();
+    mStages.shrink_to_fit();
+
+    for (auto* buffer : { &mWet, &mDry, &mEven, &mOdd }) {
+        buffer->clear();
+        buffer->shrink_to_fit();
+    }
+
+    mReducedChannels.clear();
+    mNumChannels = 0;
+    mFactor = 1;
+    mLatency = 0;
+}
+
+//==============================================================================
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::designStage (Stage& stage, double stageRate, double passbandHz)
+{
+    // The band above passbandHz may alias onto itself but never below it, so the transition
+    // runs from the pass band edge to its mirror image around a quarter of the rate:
+    const double pi = 3.14159265358979323846;
+    const double transition = 2.0 * pi * (stageRate * 0.5 - 2.0 * passbandHz) / stageRate;
+
+    // Kaiser's estimate of the length, rounded up to 4k + 3 taps so the outermost ones are not zero:
+    const double estimatedTaps = (stopBandDb - 7.95) / (2.285 * transition) + 1.0;
+    const int k = std::max(0, (int) std::ceil((estimatedTaps - 3.0) / 4.0));
+
+    stage.numTaps = 4 * k + 3;
+
+    const int centre = (stage.numTaps - 1) / 2;
+    const double beta = 0.1102 * (stopBandDb - 8.7);
+
+    // Ideal half band low pass (sinc at a quarter of the rate) under the window, the odd taps
+    // besides the centre fall on its zeros:
+    stage.taps.assign((size_t) (centre + 1), 0);
+    double sum = 0.0;
+
+    for (int i = 0; i <= centre; i++) {
+        const double x = 2 * i - centre;
+        const double r = x / centre;
+        const double sinc = std::sin(0.5 * pi * x) / (pi * x);
+        const double tap = sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+
+        stage.taps[(size_t) i] = (SampleType) tap;
+        sum += tap;
+    }
+
+    // Unity gain at DC, the centre tap of 0.5 makes up the other half:
+    stage.doubledTaps.assign(stage.taps.size(), 0);
+
+    for (size_t i = 0; i < stage.taps.size(); i++) {
+        stage.taps[i] = (SampleType) (stage.taps[i] * 0.5 / sum);
+        stage.doubledTaps[i] = stage.taps[i] * (SampleType) 2;
+    }
+}
+
+template <typename SampleType>
+int FROGGRateReducer<SampleType>::decimateStage (Stage& stage, const SampleType* const* input, int sampleStride, int numChannels, int numSamples)
+{
+    const int numTaps = stage.numTaps;
+    const int numPairs = (numTaps + 1) / 4;
+    const int total = stage.decimatorFill + numSamples;
+
+    // One output for every second input, on the newest sample of each pair:
+    const int numOutputs = total > numTaps - 1 ? (total - numTaps + 2) / 2 : 0;
+    const SampleType* taps = stage.taps.data();
+
+    SampleType* even = mEven.data();
+    SampleType* odd = mOdd.data();
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        SampleType* line = stage.decimatorLines.data() + channel * stage.lineLength;
+        SampleType* output = stage.output.data() + channel * stage.outputLength;
+
+        if (sampleStride == 1) {
+            std::memcpy(line + stage.decimatorFill, input[channel], sizeof (SampleType) * (size_t) numSamples);
+        }
+        else {
+            for (int i = 0; i < numSamples; i++) {
+                line[stage.decimatorFill + i] = input[channel][i * sampleStride];
+            }
+        }
+
+        // Every output starts on an even sample: the side taps only meet even samples, the centre
+        // tap an odd one. Split, both run along the outputs one tap at a time, which vectorises:
+        for (int j = 0; j < total / 2; j++) {
+            even[j] = line[2 * j];
+            odd[j] = line[2 * j + 1];
+        }
+
+        if (total % 2 != 0) {
+            even[total / 2] = line[total - 1];
+        }
+
+        for (int k = 0; k < numOutputs; k++) {
+            output[k] = (SampleType) 0.5 * odd[k + numPairs - 1];
+        }
+
+        addTapPairs(output, numOutputs, taps, numPairs, even, even + (numTaps - 1) / 2);
+
+        // The history of the next output moves to the front:
+        std::memmove(line, line + 2 * numOutputs, sizeof (SampleType) * (size_t) (total - 2 * numOutputs));
+    }
+
+    stage.decimatorFill = total - 2 * numOutputs;
+    return numOutputs;
+}
+
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::interpolateStage (Stage& stage, const SampleType* const* input, int numChannels, int numSamples, SampleType* const* output)
+{
+    // Zeros between the input samples, filtered: the even outputs take the side taps, the odd
+    // ones only the centre tap, all doubled for the gain the zeros take away (doubledTaps):
+    const int history = (stage.numTaps - 1) / 2;
+    const int numPairs = (history + 1) / 2;
+    const SampleType* taps = stage.doubledTaps.data();
+
+    SampleType* sums = mEven.data();
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        SampleType* line = stage.interpolatorLines.data() + channel * stage.lineLength;
+        SampleType* out = output[channel];
+
+        std::memcpy(line + history, input[channel], sizeof (SampleType) * (size_t) numSamples);
+
+        for (int k = 0; k < numSamples; k++) {
+            sums[k] = 0;
+        }
+
+        addTapPairs(sums, numSamples, taps, numPairs, line, line + history);
+
+        for (int k = 0; k < numSamples; k++) {
+            out[2 * k] = sums[k];
+            out[2 * k + 1] = line[k + numPairs];
+        }
+
+        std::memmove(line, line + numSamples, sizeof (SampleType) * (size_t) history);
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+int FROGGRateReducer<SampleType>::decimate (const SampleType* const* input, int sampleStride, int numChannels, int numSamples)
+{
+    const SampleType* stageInput[FROGGMaxChannels];
+    int stageStride = sampleStride;
+    int numStageSamples = numSamples;
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        stageInput[channel] = input[channel];
+    }
+
+    for (Stage& stage : mStages) {
+        numStageSamples = decimateStage(stage, stageInput, stageStride, numChannels, numStageSamples);
+        stageStride = 1;
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            stageInput[channel] = stage.output.data() + channel * stage.outputLength;
+        }
+    }
+
+    return numStageSamples;
+}
+
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::interpolate (int numChannels, int numReduced)
+{
+    SampleType* stageInput[FROGGMaxChannels];
+    SampleType* stageOutput[FROGGMaxChannels];
+    int numStageSamples = numReduced;
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        stageInput[channel] = mReducedChannels[(size_t) channel];
+    }
+
+    // Back up through the stages in reverse, the first one appends to the queued wet output:
+    for (int s = (int) mStages.size() - 1; s >= 0; s--) {
+        for (int channel = 0; channel < numChannels; channel++) {
+            stageOutput[channel] = s == 0 ? mWet.data() + channel * mWetLength + mNumWet
+                                          : mStages[(size_t) s - 1].output.data() + channel * mStages[(size_t) s - 1].outputLength;
+        }
+
+        interpolateStage(mStages[(size_t) s], stageInput, numChannels, numStageSamples, stageOutput);
+        numStageSamples *= 2;
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            stageInput[channel] = stageOutput[channel];
+        }
+    }
+
+    mNumWet += numStageSamples;
+}
+
+template <typename SampleType>
+void FROGGRateReducer<SampleType>::mix (SampleType* const* channels, int sampleStride, int numChannels, int numSamples, FROGGRamp dryWet)
+{
+    // At least numSamples are queued: every complete group has been interpolated, and the
+    // queue started factor - 1 samples ahead of an incomplete one:
+    for (int channel = 0; channel < numChannels; channel++) {
+        SampleType* dry = mDry.data() + channel * mDryLength;
+        SampleType* wet = mWet.data() + channel * mWetLength;
+        SampleType* samples = channels[channel];
+
+        // The input goes in behind the latency, the samples that long ago come out:
+        for (int i = 0; i < numSamples; i++) {
+            dry[mLatency + i] = samples[i * sampleStride];
+        }
+
+        for (int i = 0; i < numSamples; i++) {
+            samples[i * sampleStride] = dry[i] + (wet[i] - dry[i]) * (SampleType) dryWet.at(i);
+        }
+
+        std::memmove(dry, dry + numSamples, sizeof (SampleType) * (size_t) mLatency);
+        std::memmove(wet, wet + numSamples, sizeof (SampleType) * (size_t) (mNumWet - numSamples));
+    }
+
+    mNumWet -= numSamples;
+}
+
+template class FROGGRateReducer<float>;
+template class FROGGRateReducer<double>;
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    Half band decimation and interpolation of the wet path, for sessions
+    running well above the rate the effect needs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FROGGBlockParameters.h"
+
+#include <vector>
+
+//==============================================================================
+// Lowest rate the wet path is reduced to, and the band it keeps below that:
+static constexpr double FROGGMinReducedRate = 44100.0;
+static constexpr double FROGGReducedPassbandHz = 20000.0;
+
+// Largest reduction, two half band stages (192 kHz to 48 kHz):
+static constexpr int FROGGMaxRateReduction = 4;
+
+// Power of two the host rate is divided by to stay at or above FROGGMinReducedRate, 1 at base rates:
+int FROGGGetRateReduction (double sampleRate);
+
+//==============================================================================
+/**
+    Runs the modulated delay of a high rate session at 44.1 / 48 kHz.
+
+    decimate() band-limits the input to FROGGReducedPassbandHz and takes it down
+    by the factor in one or two 2:1 stages, the delay kernels process those
+    samples in place, and interpolate() takes them back up through the same
+    stages. Each stage is a linear phase, Kaiser windowed half band FIR (-96 dB),
+    as short as its transition band allows, with every second tap zero and the
+    symmetric pairs folded, so the 2:1 steps cost few multiplies per sample.
+
+    The dry signal never leaves the host rate: mix() delays it by exactly the
+    latency of the filters (getLatencySamples) and mixes it with the wet one.
+    Samples go through in groups of factor, an incomplete group waits for the
+    next call, which the latency covers as well. Any block size works, up to the
+    one given to prepare.
+*/
+template <typename SampleType>
+class FROGGRateReducer
+{
+public:
+    //==============================================================================
+    // Allocates numChannels for blocks of up to maxBlockSize host samples and reduces
+    // sampleRate by factor (1, 2 or FROGGMaxRateReduction), then resets:
+    void prepare (double sampleRate, int numChannels, int maxBlockSize, int factor);
+
+    // Clears the filters and the dry and wet delays. The first group of factor host samples starts
+    // groupPosition (0 .. factor - 1) samples before the next one, as if they had been silent, so
+    // the groups can be kept on multiples of the factor on a timeline:
+    void reset (int groupPosition = 0);
+
+    // Frees the memory, prepare has to be called again before use:
+    void release();
+
+    int getFactor() const { return mFactor; }
+
+    // Host samples the output lags the input by, dry and wet alike:
+    int getLatencySamples() const { return mLatency; }
+
+    //==============================================================================
+    // Takes numSamples of input, sampleStride apart (1 planar, the number of channels interleaved),
+    // down to the reduced rate, into getReducedChannels, and returns how many reduced samples there
+    // are. numChannels is at most the number prepared, the same on every call:
+    int decimate (const SampleType* const* input, int sampleStride, int numChannels, int numSamples);
+
+    // Reduced rate samples of the last decimate, to be processed in place:
+    SampleType* const* getReducedChannels() { return mReducedChannels.data(); }
+
+    // Takes the numReduced processed samples back to the host rate, queued behind the wet output:
+    void interpolate (int numChannels, int numReduced);
+
+    // Replaces the numSamples of input in channels, the ones given to decimate, with the delayed
+    // dry signal mixed with the wet one, dry + (wet - dry) * dryWet:
+    void mix (SampleType* const* channels, int sampleStride, int numChannels, int numSamples, FROGGRamp dryWet);
+
+private:
+    //==============================================================================
+    // One 2:1 step, the taps and the history of every channel in each direction:
+    struct Stage
+    {
+        // Taps 0, 2, 4 ... of the half band filter (the odd ones are zero but the 0.5 centre),
+        // symmetric, so only the first half is used:
+        std::vector<SampleType> taps;
+        std::vector<SampleType> doubledTaps;
+        int numTaps = 0;
+
+        // Filter input of every channel, the history ahead of the new samples, and how many
+        // samples the decimator holds:
+        std::vector<SampleType> decimatorLines;
+        std::vector<SampleType> interpolatorLines;
+        int decimatorFill = 0;
+        int lineLength = 0;
+
+        // Decimated samples of every channel, the input of the next stage down or of the
+        // one before on the way up:
+        std::vector<SampleType> output;
+        int outputLength = 0;
+    };
+
+    void designStage (Stage& stage, double stageRate, double passbandHz);
+    int decimateStage (Stage& stage, const SampleType* const* input, int sampleStride, int numChannels, int numSamples);
+    void interpolateStage (Stage& stage, const SampleType* const* input, int numChannels, int numSamples, SampleType* const* output);
+
+    std::vector<Stage> mStages;
+
+    // Reduced rate samples of every channel, in the output of the last stage:
+    std::vector<SampleType*> mReducedChannels;
+
+    // Wet output queued for mix(), and how many of each channel's samples are waiting:
+    std::vector<SampleType> mWet;
+    int mWetLength = 0;
+    int mNumWet = 0;
+
+    // Dry input of every channel, the last mLatency samples ahead of the new ones:
+    std::vector<SampleType> mDry;
+    int mDryLength = 0;
+
+    // Even and odd samples of a decimator line, or the sums of an interpolator:
+    std::vector<SampleType> mEven;
+    std::vector<SampleType> mOdd;
+
+    int mNumChannels = 0;
+    int mMaxBlockSize = 0;
+    int mFactor = 1;
+    int mLatency = 0;
+};
@@ -0,0 +1,403 @@
+/*
+  ==============================================================================
+
+    Small SIMD register wrappers used by the delay kernels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define FROGG_SIMD_SSE2 1
+ #include <emmintrin.h>
+
+ // Only the translation units built for these instruction sets see their wrappers (see FROGGKernels.h):
+ #if defined (__AVX2__)
+  #define FROGG_SIMD_AVX2 1
+  #include <immintrin.h>
+ #endif
+
+ #if defined (__AVX512F__)
+  #define FROGG_SIMD_AVX512 1
+ #endif
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #define FROGG_SIMD_NEON 1
+ #include <arm_neon.h>
+#endif
+
+//==============================================================================
+// Widest register any kernel uses, in float lanes:
+static constexpr int FROGGMaxLanes = 16;
+
+//==============================================================================
+// Every translation unit gets its own copy of the wrappers: the kernels are compiled once per
+// instruction set, and the code instantiated on one must never be shared with another.
+namespace
+{
+
+//==============================================================================
+/**
+    Portable fallback with the same interface as the intrinsic wrappers below,
+    plain loops the compiler can still vectorise on its own.
+
+    Every wrapper holds size lanes of SampleType (float or double), the sample
+    type the kernels built on it process.
+*/
+template <typename Sample, int NumLanes>
+struct FROGGVecFallback
+{
+    using SampleType = Sample;
+    static constexpr int size = NumLanes;
+
+    SampleType v[NumLanes];
+
+    static FROGGVecFallback load (const SampleType* source)
+    {
+        FROGGVecFallback r;
+        for (int i = 0; i < NumLanes; i++) r.v[i] = source[i];
+        return r;
+    }
+
+    static FROGGVecFallback broadcast (SampleType value)
+    {
+        FROGGVecFallback r;
+        for (int i = 0; i < NumLanes; i++) r.v[i] = value;
+        return r;
+    }
+
+    void store (SampleType* dest) const
+    {
+        for (int i = 0; i < NumLanes; i++) dest[i] = v[i];
+    }
+
+    // Lane i from base[offsets[i]], and the same from float memory:
+    static FROGGVecFallback gather (const SampleType* base, const int* offsets)
+    {
+        FROGGVecFallback r;
+        for (int i = 0; i < NumLanes; i++) r.v[i] = base[offsets[i]];
+        return r;
+    }
+
+    static FROGGVecFallback gatherFloat (const float* base, const int* offsets)
+    {
+        FROGGVecFallback r;
+        for (int i = 0; i < NumLanes; i++) r.v[i] = (SampleType) base[offsets[i]];
+        return r;
+    }
+
+    // Rounds every lane down to an integer, returned both as lanes and in index:
+    static FROGGVecFallback floor (FROGGVecFallback x, int* index)
+    {
+        FROGGVecFallback r;
+        for (int i = 0; i < NumLanes; i++) {
+            index[i] = (int) x.v[i] - (x.v[i] < (SampleType) (int) x.v[i] ? 1 : 0);
+            r.v[i] = (SampleType) index[i];
+        }
+        return r;
+    }
+
+    friend FROGGVecFallback operator+ (FROGGVecFallback a, FROGGVecFallback b) { for (int i = 0; i < NumLanes; i++) a.v[i] += b.v[i]; return a; }
+    friend FROGGVecFallback operator- (FROGGVecFallback a, FROGGVecFallback b) { for (int i = 0; i < NumLanes; i++) a.v[i] -= b.v[i]; return a; }
+    friend FROGGVecFallback operator* (FROGGVecFallback a, FROGGVecFallback b) { for (int i = 0; i < NumLanes; i++) a.v[i] *= b.v[i]; return a; }
+};
+
+//==============================================================================
+#if FROGG_SIMD_SSE2
+// Four float lanes in one SSE2 register:
+struct FROGGVecSSE2
+{
+    using SampleType = float;
+    static constexpr int size = 4;
+
+    __m128 v;
+
+    static FROGGVecSSE2 load (const float* source)    { return { _mm_loadu_ps (source) }; }
+    static FROGGVecSSE2 broadcast (float value)       { return { _mm_set1_ps (value) }; }
+    void store (float* dest) const                    { _mm_storeu_ps (dest, v); }
+
+    // No gather instruction before AVX2, one load per lane:
+    static FROGGVecSSE2 gather (const float* base, const int* offsets)
+    {
+        return { _mm_setr_ps (base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]) };
+    }
+
+    static FROGGVecSSE2 gatherFloat (const float* base, const int* offsets)   { return gather (base, offsets); }
+
+    static FROGGVecSSE2 floor (FROGGVecSSE2 x, int* index)
+    {
+        // Truncate, then step down the lanes that were negative with a fraction:
+        __m128i truncated = _mm_cvttps_epi32 (x.v);
+        __m128 t = _mm_cvtepi32_ps (truncated);
+        __m128i adjust = _mm_castps_si128 (_mm_cmpgt_ps (t, x.v));
+        truncated = _mm_add_epi32 (truncated, adjust);
+        _mm_storeu_si128 ((__m128i*) index, truncated);
+        return { _mm_cvtepi32_ps (truncated) };
+    }
+
+    friend FROGGVecSSE2 operator+ (FROGGVecSSE2 a, FROGGVecSSE2 b) { return { _mm_add_ps (a.v, b.v) }; }
+    friend FROGGVecSSE2 operator- (FROGGVecSSE2 a, FROGGVecSSE2 b) { return { _mm_sub_ps (a.v, b.v) }; }
+    friend FROGGVecSSE2 operator* (FROGGVecSSE2 a, FROGGVecSSE2 b) { return { _mm_mul_ps (a.v, b.v) }; }
+};
+
+// Two double lanes in one SSE2 register:
+struct FROGGVecSSE2Double
+{
+    using SampleType = double;
+    static constexpr int size = 2;
+
+    __m128d v;
+
+    static FROGGVecSSE2Double load (const double* source)   { return { _mm_loadu_pd (source) }; }
+    static FROGGVecSSE2Double broadcast (double value)      { return { _mm_set1_pd (value) }; }
+    void store (double* dest) const                         { _mm_storeu_pd (dest, v); }
+
+    static FROGGVecSSE2Double gather (const double* base, const int* offsets)
+    {
+        return { _mm_setr_pd (base[offsets[0]], base[offsets[1]]) };
+    }
+
+    static FROGGVecSSE2Double gatherFloat (const float* base, const int* offsets)
+    {
+        return { _mm_setr_pd ((double) base[offsets[0]], (double) base[offsets[1]]) };
+    }
+
+    static FROGGVecSSE2Double floor (FROGGVecSSE2Double x, int* index)
+    {
+        // Truncate, then subtract one from the lanes that were negative with a fraction:
+        __m128d t = _mm_cvtepi32_pd (_mm_cvttpd_epi32 (x.v));
+        __m128d floored = _mm_sub_pd (t, _mm_and_pd (_mm_cmpgt_pd (t, x.v), _mm_set1_pd (1.0)));
+        _mm_storel_epi64 ((__m128i*) index, _mm_cvttpd_epi32 (floored));
+        return { floored };
+    }
+
+    friend FROGGVecSSE2Double operator+ (FROGGVecSSE2Double a, FROGGVecSSE2Double b) { return { _mm_add_pd (a.v, b.v) }; }
+    friend FROGGVecSSE2Double operator- (FROGGVecSSE2Double a, FROGGVecSSE2Double b) { return { _mm_sub_pd (a.v, b.v) }; }
+    friend FROGGVecSSE2Double operator* (FROGGVecSSE2Double a, FROGGVecSSE2Double b) { return { _mm_mul_pd (a.v, b.v) }; }
+};
+
+#if FROGG_SIMD_AVX2
+// Eight float lanes in one AVX register:
+struct FROGGVecAVX2
+{
+    using SampleType = float;
+    static constexpr int size = 8;
+
+    __m256 v;
+
+    static FROGGVecAVX2 load (const float* source)    { return { _mm256_loadu_ps (source) }; }
+    static FROGGVecAVX2 broadcast (float value)       { return { _mm256_set1_ps (value) }; }
+    void store (float* dest) const                    { _mm256_storeu_ps (dest, v); }
+
+    static FROGGVecAVX2 gather (const float* base, const int* offsets)
+    {
+        return { _mm256_i32gather_ps (base, _mm256_loadu_si256 ((const __m256i*) offsets), 4) };
+    }
+
+    static FROGGVecAVX2 gatherFloat (const float* base, const int* offsets)   { return gather (base, offsets); }
+
+    static FROGGVecAVX2 floor (FROGGVecAVX2 x, int* index)
+    {
+        __m256 floored = _mm256_floor_ps (x.v);
+        _mm256_storeu_si256 ((__m256i*) index, _mm256_cvttps_epi32 (floored));
+        return { floored };
+    }
+
+    friend FROGGVecAVX2 operator+ (FROGGVecAVX2 a, FROGGVecAVX2 b) { return { _mm256_add_ps (a.v, b.v) }; }
+    friend FROGGVecAVX2 operator- (FROGGVecAVX2 a, FROGGVecAVX2 b) { return { _mm256_sub_ps (a.v, b.v) }; }
+    friend FROGGVecAVX2 operator* (FROGGVecAVX2 a, FROGGVecAVX2 b) { return { _mm256_mul_ps (a.v, b.v) }; }
+};
+
+// Four double lanes in one AVX register:
+struct FROGGVecAVX2Double
+{
+    using SampleType = double;
+    static constexpr int size = 4;
+
+    __m256d v;
+
+    static FROGGVecAVX2Double load (const double* source)   { return { _mm256_loadu_pd (source) }; }
+    static FROGGVecAVX2Double broadcast (double value)      { return { _mm256_set1_pd (value) }; }
+    void store (double* dest) const                         { _mm256_storeu_pd (dest, v); }
+
+    static FROGGVecAVX2Double gather (const double* base, const int* offsets)
+    {
+        return { _mm256_i32gather_pd (base, _mm_loadu_si128 ((const __m128i*) offsets), 8) };
+    }
+
+    static FROGGVecAVX2Double gatherFloat (const float* base, const int* offsets)
+    {
+        return { _mm256_cvtps_pd (_mm_i32gather_ps (base, _mm_loadu_si128 ((const __m128i*) offsets), 4)) };
+    }
+
+    static FROGGVecAVX2Double floor (FROGGVecAVX2Double x, int* index)
+    {
+        __m256d floored = _mm256_floor_pd (x.v);
+        _mm_storeu_si128 ((__m128i*) index, _mm256_cvttpd_epi32 (floored));
+        return { floored };
+    }
+
+    friend FROGGVecAVX2Double operator+ (FROGGVecAVX2Double a, FROGGVecAVX2Double b) { return { _mm256_add_pd (a.v, b.v) }; }
+    friend FROGGVecAVX2Double operator- (FROGGVecAVX2Double a, FROGGVecAVX2Double b) { return { _mm256_sub_pd (a.v, b.v) }; }
+    friend FROGGVecAVX2Double operator* (FROGGVecAVX2Double a, FROGGVecAVX2Double b) { return { _mm256_mul_pd (a.v, b.v) }; }
+};
+#endif
+
+#if FROGG_SIMD_AVX512
+// Sixteen float lanes in one AVX-512 register:
+struct FROGGVecAVX512
+{
+    using SampleType = float;
+    static constexpr int size = 16;
+
+    __m512 v;
+
+    static FROGGVecAVX512 load (const float* source)  { return { _mm512_loadu_ps (source) }; }
+    static FROGGVecAVX512 broadcast (float value)     { return { _mm512_set1_ps (value) }; }
+    void store (float* dest) const                    { _mm512_storeu_ps (dest, v); }
+
+    static FROGGVecAVX512 gather (const float* base, const int* offsets)
+    {
+        return { _mm512_i32gather_ps (_mm512_loadu_si512 (offsets), base, 4) };
+    }
+
+    static FROGGVecAVX512 gatherFloat (const float* base, const int* offsets)   { return gather (base, offsets); }
+
+    static FROGGVecAVX512 floor (FROGGVecAVX512 x, int* index)
+    {
+        __m512 floored = _mm512_roundscale_ps (x.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm512_storeu_si512 (index, _mm512_cvttps_epi32 (floored));
+        return { floored };
+    }
+
+    friend FROGGVecAVX512 operator+ (FROGGVecAVX512 a, FROGGVecAVX512 b) { return { _mm512_add_ps (a.v, b.v) }; }
+    friend FROGGVecAVX512 operator- (FROGGVecAVX512 a, FROGGVecAVX512 b) { return { _mm512_sub_ps (a.v, b.v) }; }
+    friend FROGGVecAVX512 operator* (FROGGVecAVX512 a, FROGGVecAVX512 b) { return { _mm512_mul_ps (a.v, b.v) }; }
+};
+
+// Eight double lanes in one AVX-512 register:
+struct FROGGVecAVX512Double
+{
+    using SampleType = double;
+    static constexpr int size = 8;
+
+    __m512d v;
+
+    static FROGGVecAVX512Double load (const double* source)     { return { _mm512_loadu_pd (source) }; }
+    static FROGGVecAVX512Double broadcast (double value)        { return { _mm512_set1_pd (value) }; }
+    void store (double* dest) const                             { _mm512_storeu_pd (dest, v); }
+
+    static FROGGVecAVX512Double gather (const double* base, const int* offsets)
+    {
+        return { _mm512_i32gather_pd (_mm256_loadu_si256 ((const __m256i*) offsets), base, 8) };
+    }
+
+    static FROGGVecAVX512Double gatherFloat (const float* base, const int* offsets)
+    {
+        return { _mm512_cvtps_pd (_mm256_i32gather_ps (base, _mm256_loadu_si256 ((const __m256i*) offsets), 4)) };
+    }
+
+    static FROGGVecAVX512Double floor (FROGGVecAVX512Double x, int* index)
+    {
+        __m512d floored = _mm512_roundscale_pd (x.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm256_storeu_si256 ((__m256i*) index, _mm512_cvttpd_epi32 (floored));
+        return { floored };
+    }
+
+    friend FROGGVecAVX512Double operator+ (FROGGVecAVX512Double a, FROGGVecAVX512Double b) { return { _mm512_add_pd (a.v, b.v) }; }
+    friend FROGGVecAVX512Double operator- (FROGGVecAVX512Double a, FROGGVecAVX512Double b) { return { _mm512_sub_pd (a.v, b.v) }; }
+    friend FROGGVecAVX512Double operator* (FROGGVecAVX512Double a, FROGGVecAVX512Double b) { return { _mm512_mul_pd (a.v, b.v) }; }
+};
+#endif
+
+using FROGGFloatVec = FROGGVecSSE2;
+using FROGGDoubleVec = FROGGVecSSE2Double;
+
+#elif FROGG_SIMD_NEON
+// Four float lanes in one NEON register:
+struct FROGGVecNEON
+{
+    using SampleType = float;
+    static constexpr int size = 4;
+
+    float32x4_t v;
+
+    static FROGGVecNEON load (const float* source)    { return { vld1q_f32 (source) }; }
+    static FROGGVecNEON broadcast (float value)       { return { vdupq_n_f32 (value) }; }
+    void store (float* dest) const                    { vst1q_f32 (dest, v); }
+
+    // No gather instruction, one load per lane:
+    static FROGGVecNEON gather (const float* base, const int* offsets)
+    {
+        const float lanes[4] = { base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]] };
+        return { vld1q_f32 (lanes) };
+    }
+
+    static FROGGVecNEON gatherFloat (const float* base, const int* offsets)   { return gather (base, offsets); }
+
+    static FROGGVecNEON floor (FROGGVecNEON x, int* index)
+    {
+        int32x4_t truncated = vcvtq_s32_f32 (x.v);
+        uint32x4_t adjust = vcgtq_f32 (vcvtq_f32_s32 (truncated), x.v);
+        truncated = vaddq_s32 (truncated, vreinterpretq_s32_u32 (adjust));
+        vst1q_s32 (index, truncated);
+        return { vcvtq_f32_s32 (truncated) };
+    }
+
+    friend FROGGVecNEON operator+ (FROGGVecNEON a, FROGGVecNEON b) { return { vaddq_f32 (a.v, b.v) }; }
+    friend FROGGVecNEON operator- (FROGGVecNEON a, FROGGVecNEON b) { return { vsubq_f32 (a.v, b.v) }; }
+    friend FROGGVecNEON operator* (FROGGVecNEON a, FROGGVecNEON b) { return { vmulq_f32 (a.v, b.v) }; }
+};
+
+using FROGGFloatVec = FROGGVecNEON;
+
+ #if defined (__aarch64__) || defined (_M_ARM64)
+// Two double lanes in one NEON register (AArch64 only):
+struct FROGGVecNEONDouble
+{
+    using SampleType = double;
+    static constexpr int size = 2;
+
+    float64x2_t v;
+
+    static FROGGVecNEONDouble load (const double* source)   { return { vld1q_f64 (source) }; }
+    static FROGGVecNEONDouble broadcast (double value)      { return { vdupq_n_f64 (value) }; }
+    void store (double* dest) const                         { vst1q_f64 (dest, v); }
+
+    static FROGGVecNEONDouble gather (const double* base, const int* offsets)
+    {
+        const double lanes[2] = { base[offsets[0]], base[offsets[1]] };
+        return { vld1q_f64 (lanes) };
+    }
+
+    static FROGGVecNEONDouble gatherFloat (const float* base, const int* offsets)
+    {
+        const double lanes[2] = { (double) base[offsets[0]], (double) base[offsets[1]] };
+        return { vld1q_f64 (lanes) };
+    }
+
+    static FROGGVecNEONDouble floor (FROGGVecNEONDouble x, int* index)
+    {
+        float64x2_t floored = vrndmq_f64 (x.v);
+        int64x2_t integers = vcvtq_s64_f64 (floored);
+        index[0] = (int) vgetq_lane_s64 (integers, 0);
+        index[1] = (int) vgetq_lane_s64 (integers, 1);
+        return { floored };
+    }
+
+    friend FROGGVecNEONDouble operator+ (FROGGVecNEONDouble a, FROGGVecNEONDouble b) { return { vaddq_f64 (a.v, b.v) }; }
+    friend FROGGVecNEONDouble operator- (FROGGVecNEONDouble a, FROGGVecNEONDouble b) { return { vsubq_f64 (a.v, b.v) }; }
+    friend FROGGVecNEONDouble operator* (FROGGVecNEONDouble a, FROGGVecNEONDouble b) { return { vmulq_f64 (a.v, b.v) }; }
+};
+
+using FROGGDoubleVec = FROGGVecNEONDouble;
+ #else
+using FROGGDoubleVec = FROGGVecFallback<double, 2>;
+ #endif
+
+#else
+using FROGGFloatVec = FROGGVecFallback<float, 4>;
+using FROGGDoubleVec = FROGGVecFallback<double, 2>;
+#endif
+
+} // namespace
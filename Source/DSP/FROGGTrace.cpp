@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    Scoped timing zones around the processing stages, written out as a
+    Chrome / Perfetto trace. Only built with FROGG_ENABLE_TRACING.
+
+  ==============================================================================
+*/
+
+#include "FROGGTrace.h"
+
+#if FROGG_ENABLE_TRACING
+
+#include <chrono>
+#include <cstdio>
+#include <new>
+
+//==============================================================================
+FROGGTrace& FROGGTrace::getInstance()
+{
+    // Never destroyed, a thread still recording at exit finds it in place:
+    static FROGGTrace* instance = new FROGGTrace();
+    return *instance;
+}
+
+int64_t FROGGTrace::getTimeNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//==============================================================================
+void FROGGTrace::startSession (const std::string& filePath)
+{
+    FROGGTrace& trace = getInstance();
+    std::lock_guard<std::mutex> lock(trace.mSessionLock);
+
+    if (trace.mNumSessions++ > 0)
+        return;
+
+    // Every ring a recording thread may claim, allocated here rather than on that thread:
+    if (trace.mThreadBuffers.empty()) {
+        for (int i = 0; i < maxThreads; i++) {
+            trace.mThreadBuffers.push_back(std::make_unique<ThreadBuffer>());
+        }
+    }
+
+    trace.mFile.open(filePath, std::ios::out | std::ios::trunc);
+    trace.mFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    trace.mFirstEvent = true;
+
+    // Whatever the rings still hold from an earlier session is left out:
+    for (const std::unique_ptr<ThreadBuffer>& buffer : trace.mThreadBuffers) {
+        buffer->readIndex.store(buffer->writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        buffer->numDropped.store(0, std::memory_order_relaxed);
+    }
+
+    trace.mNumUnclaimed.store(0, std::memory_order_relaxed);
+    trace.mSessionGeneration.fetch_add(1, std::memory_order_release);
+    trace.mThreadIds.clear();
+    trace.mSessionStart = getTimeNs();
+    trace.mStopWriter = false;
+    trace.mIsRecording.store(true, std::memory_order_release);
+    trace.mWriter = std::thread([&trace] { trace.runWriter(); });
+}
+
+void FROGGTrace::stopSession()
+{
+    FROGGTrace& trace = getInstance();
+    std::lock_guard<std::mutex> lock(trace.mSessionLock);
+
+    if (trace.mNumSessions == 0 || --trace.mNumSessions > 0)
+        return;
+
+    trace.mIsRecording.store(false, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> writerLock(trace.mWriterLock);
+        trace.mStopWriter = true;
+    }
+
+    trace.mWriterWakeUp.notify_one();
+    trace.mWriter.join();
+
+    // The writer is gone, the file is this thread's:
+    trace.flush();
+
+    // Every ring is free for the threads of the next session, which claim them again:
+    for (const std::unique_ptr<ThreadBuffer>& buffer : trace.mThreadBuffers) {
+        buffer->isClaimed.store(false, std::memory_order_release);
+    }
+
+    // Thread names for the viewer, and the events the full rings, or threads without one, lost:
+    uint32_t numDropped = trace.mNumUnclaimed.load(std::memory_order_relaxed);
+
+    trace.mFile << (trace.mFirstEvent ? "" : ",\n") << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"FROGG\"}}";
+
+    for (int threadId : trace.mThreadIds) {
+        trace.mFile << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId
+                    << ",\"args\":{\"name\":\"Thread " << threadId << "\"}}";
+    }
+
+    for (const std::unique_ptr<ThreadBuffer>& buffer : trace.mThreadBuffers) {
+        numDropped += buffer->numDropped.load(std::memory_order_relaxed);
+    }
+
+    trace.mFile << "\n],\"otherData\":{\"droppedEvents\":\"" << numDropped << "\"}}\n";
+    trace.mFile.close();
+}
+
+//==============================================================================
+void FROGGTrace::record (const char* name, int64_t start, int64_t end) noexcept
+{
+    FROGGTrace& trace = getInstance();
+
+    // The rings exist once a session has started:
+    if (! trace.mIsRecording.load(std::memory_order_acquire))
+        return;
+
+    // The thread's ring, index + 1, and the session it claimed it in. Trivially destructible, so
+    // the thread registers nothing to run at its exit:
+    thread_local int threadBufferIndex = 0;
+    thread_local int threadGeneration = 0;
+
+    const int generation = trace.mSessionGeneration.load(std::memory_order_acquire);
+
+    if (threadBufferIndex == 0 || threadGeneration != generation) {
+        threadBufferIndex = trace.claimThreadBuffer();
+        threadGeneration = generation;
+
+        if (threadBufferIndex == 0) {
+            trace.mNumUnclaimed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    ThreadBuffer* buffer = trace.mThreadBuffers[(size_t) threadBufferIndex - 1].get();
+
+    // Only this thread moves the write index, the writer only ever frees slots:
+    const uint32_t writeIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+
+    if (writeIndex - buffer->readIndex.load(std::memory_order_acquire) >= (uint32_t) eventsPerThread) {
+        buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[writeIndex & (eventsPerThread - 1)] = { name, start, end, buffer->threadId };
+    buffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+int FROGGTrace::claimThreadBuffer() noexcept
+{
+    for (size_t i = 0; i < mThreadBuffers.size(); i++) {
+        ThreadBuffer& buffer = *mThreadBuffers[i];
+        bool isClaimed = false;
+
+        if (buffer.isClaimed.compare_exchange_strong(isClaimed, true, std::memory_order_acq_rel)) {
+            // Every thread gets an id of its own, also on a ring an earlier one had:
+            buffer.threadId = mNumThreadIds.fetch_add(1, std::memory_order_relaxed) + 1;
+            return (int) i + 1;
+        }
+    }
+
+    return 0;
+}
+
+//==============================================================================
+void FROGGTrace::runWriter()
+{
+    std::unique_lock<std::mutex> lock(mWriterLock);
+
+    while (! mStopWriter) {
+        mWriterWakeUp.wait_for(lock, std::chrono::milliseconds(flushIntervalMs), [this] { return mStopWriter; });
+
+        // Nothing a recording thread waits for is held while writing:
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void FROGGTrace::flush()
+{
+    char line[256];
+
+    for (const std::unique_ptr<ThreadBuffer>& buffer : mThreadBuffers) {
+        const uint32_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        uint32_t readIndex = buffer->readIndex.load(std::memory_order_relaxed);
+
+        for (; readIndex != writeIndex; readIndex++) {
+            const Event& event = buffer->events[readIndex & (eventsPerThread - 1)];
+
+            // Zones opened before the session began are cut off:
+            if (event.start < mSessionStart)
+                continue;
+
+            // Complete events, timestamps and durations in microseconds:
+            std::snprintf(line, sizeof (line), "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                          mFirstEvent ? "" : ",\n", event.name, event.threadId,
+                          (double) (event.start - mSessionStart) * 0.001, (double) (event.end - event.start) * 0.001);
+
+            mFile << line;
+            mFirstEvent = false;
+            mThreadIds.insert(event.threadId);
+        }
+
+        buffer->readIndex.store(writeIndex, std::memory_order_release);
+    }
+
+    mFile.flush();
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    Scoped timing zones around the processing stages, written out as a
+    Chrome / Perfetto trace. Only built with FROGG_ENABLE_TRACING.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// The Tracing build configurations set this to 1, every other build compiles the zones out:
+#ifndef FROGG_ENABLE_TRACING
+ #define FROGG_ENABLE_TRACING 0
+#endif
+
+#if FROGG_ENABLE_TRACING
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+/**
+    Process-wide recorder of timing zones.
+
+    The first session allocates maxThreads rings of events, kept for the life of
+    the process. Every thread that records claims a free one the first time in
+    a session, with an atomic flag, and only ever writes to that one until the
+    session stops and gives every ring back: a finished zone is two clock reads
+    and a store, without locks or allocation on the recording thread, and the
+    thread only keeps plain ints, nothing to destroy at its exit. A full ring
+    drops events, which the trace reports, rather than wait, and so does a
+    thread finding every ring taken, also by threads that exited meanwhile.
+
+    A writer thread drains the rings every flushIntervalMs into the trace file,
+    in the Chrome trace event format that chrome://tracing and ui.perfetto.dev
+    open; only it touches the file while the session runs. Zones are only
+    recorded while a session runs; every plugin instance of the process starts
+    one and the first one's file is used until the last one stops it.
+*/
+class FROGGTrace
+{
+public:
+    //==============================================================================
+    static constexpr int maxThreads = 16;
+    static constexpr int eventsPerThread = 1 << 15;
+    static constexpr int flushIntervalMs = 50;
+
+    // Records the time from construction to destruction under name, a string literal:
+    class Zone
+    {
+    public:
+        explicit Zone (const char* name) noexcept : mName(name), mStart(getTimeNs()) {}
+        ~Zone() { record(mName, mStart, getTimeNs()); }
+
+        Zone (const Zone&) = delete;
+        Zone& operator= (const Zone&) = delete;
+
+    private:
+        const char* mName;
+        int64_t mStart;
+    };
+
+    //==============================================================================
+    // Starts writing to filePath, or counts one more user of the running session. Not real-time
+    // safe, like stopSession:
+    static void startSession (const std::string& filePath);
+
+    // Ends the session once every start is matched, and completes the file. Every start needs
+    // its stop, a session left running at exit leaves the file unfinished:
+    static void stopSession();
+
+    // Steady clock time in nanoseconds:
+    static int64_t getTimeNs() noexcept;
+
+    // Adds a zone to the calling thread's ring, when a session runs:
+    static void record (const char* name, int64_t start, int64_t end) noexcept;
+
+private:
+    //==============================================================================
+    struct Event
+    {
+        const char* name;
+        int64_t start;
+        int64_t end;
+        int threadId;
+    };
+
+    // Single producer (the thread that claimed it), single consumer (the writer) ring:
+    struct ThreadBuffer
+    {
+        ThreadBuffer() : events(eventsPerThread) {}
+
+        std::vector<Event> events;
+        std::atomic<uint32_t> writeIndex { 0 };
+        std::atomic<uint32_t> readIndex { 0 };
+        std::atomic<uint32_t> numDropped { 0 };
+        std::atomic<bool> isClaimed { false };
+        int threadId = 0;               // Of the thread that claimed it
+    };
+
+    FROGGTrace() = default;
+
+    static FROGGTrace& getInstance();
+
+    // Claims a free ring for the calling thread, its index + 1, or 0 while every one is taken:
+    int claimThreadBuffer() noexcept;
+
+    void runWriter();
+
+    // Writes every event recorded so far, from the writer or once it has stopped:
+    void flush();
+
+    // Session count and file, taken by startSession and stopSession only:
+    std::mutex mSessionLock;
+
+    // Wakes the writer up to stop:
+    std::mutex mWriterLock;
+    std::condition_variable mWriterWakeUp;
+    bool mStopWriter = false;
+
+    // Allocated by the first session and never resized:
+    std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers;
+    std::atomic<int> mNumThreadIds { 0 };
+    std::atomic<uint32_t> mNumUnclaimed { 0 };
+
+    // Counts the sessions, a ring claimed in an earlier one is no longer the thread's:
+    std::atomic<int> mSessionGeneration { 0 };
+
+    // Threads the writer has seen events of, named in the trace:
+    std::set<int> mThreadIds;
+
+    std::ofstream mFile;
+    std::thread mWriter;
+    std::atomic<bool> mIsRecording { false };
+    bool mFirstEvent = true;
+    int mNumSessions = 0;
+    int64_t mSessionStart = 0;
+};
+
+#define FROGG_TRACE_JOIN_(a, b) a##b
+#define FROGG_TRACE_JOIN(a, b) FROGG_TRACE_JOIN_(a, b)
+
+// Times the rest of the enclosing scope:
+#define FROGG_TRACE_ZONE(name) const FROGGTrace::Zone FROGG_TRACE_JOIN(froggTraceZone, __LINE__) (name)
+
+#else
+
+#define FROGG_TRACE_ZONE(name)
+
+#endif
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    The plugin's oversampling filters, juce::dsp::Oversampling behind the
+    FROGGOversampler interface of the core.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/FROGGCore.h"
+
+//==============================================================================
+/**
+    Polyphase IIR half band up / down sampler for 2x or 4x, the filters the
+    plugin has always oversampled with. Planar buffers only, which is all a
+    juce::AudioBuffer hands over.
+*/
+template <typename SampleType>
+class FROGGJUCEOversampler  : public FROGGOversampler<SampleType>
+{
+public:
+    //==============================================================================
+    FROGGJUCEOversampler (int factor, int numChannels, int maxBlockSize)
+        : mOversampling ((size_t) numChannels, (size_t) (factor == 2 ? 1 : 2),
+                         juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, true)
+    {
+        mOversampling.initProcessing((size_t) maxBlockSize);
+    }
+
+    int getLatencySamples() const override
+    {
+        return juce::roundToInt(mOversampling.getLatencyInSamples());
+    }
+
+    void reset() override
+    {
+        mOversampling.reset();
+    }
+
+    SampleType* const* processUp (const SampleType* const* input, int sampleStride, int numChannels, int numSamples) override
+    {
+        jassert (sampleStride == 1);
+
+        juce::dsp::AudioBlock<const SampleType> block(input, (size_t) numChannels, (size_t) numSamples);
+        juce::dsp::AudioBlock<SampleType> oversampledBlock = mOversampling.processSamplesUp(block);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            mChannels[channel] = oversampledBlock.getChannelPointer((size_t) channel);
+        }
+
+        return mChannels;
+    }
+
+    void processDown (SampleType* const* output, int sampleStride, int numChannels, int numSamples) override
+    {
+        jassert (sampleStride == 1);
+
+        juce::dsp::AudioBlock<SampleType> block(output, (size_t) numChannels, (size_t) numSamples);
+        mOversampling.processSamplesDown(block);
+    }
+
+private:
+    //==============================================================================
+    juce::dsp::Oversampling<SampleType> mOversampling;
+
+    // Channels of the last up sampled block:
+    SampleType* mChannels[FROGGMaxChannels] = {};
+
+    JUCE_DECLARE_NON_COPYABLE (FROGGJUCEOversampler)
+};
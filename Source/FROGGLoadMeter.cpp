@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    Measures how much of each audio callback's real-time budget the
+    processing uses.
+
+  ==============================================================================
+*/
+
+#include "FROGGLoadMeter.h"
+
+//==============================================================================
+FROGGLoadMeter::ScopedBlock::ScopedBlock (FROGGLoadMeter& meter, int numSamples)
+    : mMeter(meter),
+      mNumSamples(numSamples),
+      mStartTicks(juce::Time::getHighResolutionTicks())
+{
+}
+
+FROGGLoadMeter::ScopedBlock::~ScopedBlock()
+{
+    const juce::int64 ticks = juce::Time::getHighResolutionTicks() - mStartTicks;
+    mMeter.registerBlock(juce::Time::highResolutionTicksToSeconds(ticks), mNumSamples);
+}
+
+//==============================================================================
+void FROGGLoadMeter::prepare (double sampleRate, int maximumBlockSize)
+{
+    mSampleRate = sampleRate;
+    mMeasurer.reset(sampleRate, maximumBlockSize);
+    resetPeak();
+}
+
+float FROGGLoadMeter::getLoad() const
+{
+    return (float) mMeasurer.getLoadAsProportion();
+}
+
+float FROGGLoadMeter::getPeakLoad() const
+{
+    return mPeakLoad.load();
+}
+
+int FROGGLoadMeter::getNumOverruns() const
+{
+    return mMeasurer.getXRunCount();
+}
+
+void FROGGLoadMeter::resetPeak()
+{
+    mPeakLoad = 0.0f;
+}
+
+void FROGGLoadMeter::registerBlock (double seconds, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // Smoothed load and overrun count:
+    mMeasurer.registerRenderTime(seconds * 1000.0, numSamples);
+
+    // Peak of the single block loads, raised without a lock:
+    const float load = (float) (seconds * mSampleRate.load() / numSamples);
+    float peak = mPeakLoad.load();
+
+    while (load > peak && ! mPeakLoad.compare_exchange_weak(peak, load)) {
+    }
+}
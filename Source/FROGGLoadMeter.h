@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    Measures how much of each audio callback's real-time budget the
+    processing uses.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    CPU load of the audio callback, written by the audio thread and read by the
+    editor without locks.
+
+    Every block is timed with the high resolution counter and compared against
+    its budget (numSamples / sampleRate). juce::AudioProcessLoadMeasurer keeps
+    the smoothed load and counts the blocks over budget, the peak of the single
+    block loads is kept here. Nothing allocates or blocks on the audio thread.
+*/
+class FROGGLoadMeter
+{
+public:
+    //==============================================================================
+    // Times one block from construction to destruction:
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock (FROGGLoadMeter& meter, int numSamples);
+        ~ScopedBlock();
+
+    private:
+        FROGGLoadMeter& mMeter;
+        int mNumSamples;
+        juce::int64 mStartTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+
+    //==============================================================================
+    // Resets the statistics for a new sample rate and block size:
+    void prepare (double sampleRate, int maximumBlockSize);
+
+    // Smoothed share of the budget in use, 1 means all of it:
+    float getLoad() const;
+
+    // Highest single block share of the budget since prepare or resetPeak:
+    float getPeakLoad() const;
+
+    // Blocks that took longer than their budget since prepare:
+    int getNumOverruns() const;
+
+    void resetPeak();
+
+private:
+    //==============================================================================
+    void registerBlock (double seconds, int numSamples);
+
+    juce::AudioProcessLoadMeasurer mMeasurer;
+    std::atomic<double> mSampleRate { 44100.0 };
+    std::atomic<float> mPeakLoad { 0.0f };
+};
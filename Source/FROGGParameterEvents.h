@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    Parameter changes with a sample position inside the next block.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+/**
+    Fixed size list of timed parameter changes, filled on the audio thread
+    before processBlock and consumed by it.
+
+    Each event changes one parameter (by index, normalised 0..1 value) at a
+    sample offset from the start of the next block. Events
+    past the end of a block are kept for the following blocks. Nothing
+    allocates: when the list is full new events are refused.
+*/
+class FROGGParameterEvents
+{
+public:
+    //==============================================================================
+    struct Event
+    {
+        int sampleOffset;
+        int parameterIndex;
+        float value;
+    };
+
+    static constexpr int maxEvents = 512;
+
+    //==============================================================================
+    // Adds an event, false when the list is full:
+    bool add (int sampleOffset, int parameterIndex, float value)
+    {
+        if (mNumEvents == maxEvents) {
+            return false;
+        }
+
+        mEvents[mNumEvents++] = { sampleOffset < 0 ? 0 : sampleOffset, parameterIndex, value };
+        return true;
+    }
+
+    // Sorts the events by position, keeping the order of events at the same sample. An insertion
+    // sort in place: std::stable_sort may allocate a buffer, and hosts mostly send events in order,
+    // which it passes over once:
+    void sort()
+    {
+        for (int i = 1; i < mNumEvents; i++) {
+            const Event event = mEvents[i];
+            int j = i;
+
+            for (; j > 0 && mEvents[j - 1].sampleOffset > event.sampleOffset; j--) {
+                mEvents[j] = mEvents[j - 1];
+            }
+
+            mEvents[j] = event;
+        }
+    }
+
+    bool isEmpty() const                { return mNumEvents == 0; }
+    int size() const                    { return mNumEvents; }
+    const Event& operator[] (int i) const { return mEvents[i]; }
+
+    // Drops the first numUsed events (sorted) and moves the rest numSamples earlier, for the next block:
+    void removeFirst (int numUsed, int numSamples)
+    {
+        for (int i = numUsed; i < mNumEvents; i++) {
+            mEvents[i - numUsed] = { mEvents[i].sampleOffset - numSamples, mEvents[i].parameterIndex, mEvents[i].value };
+        }
+
+        mNumEvents -= numUsed;
+    }
+
+    void clear()                        { mNumEvents = 0; }
+
+private:
+    //==============================================================================
+    Event mEvents[maxEvents];
+    int mNumEvents = 0;
+};
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    Factory preset bank, exposed to the host through the program API.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+/**
+    Values of the sound parameters of one preset, in parameter units.
+
+    Interpolation, oversampling and LFO sync are left as they are when a preset
+    is applied: they are quality and timing settings, not part of the sound.
+*/
+struct FROGGPreset
+{
+    const char* name;
+    float dryWet;
+    float depth;
+    float rate;
+    float phaseOffset;
+    float feedback;
+    int type;       // 0 Chorus, 1 Flanger
+    int voices;
+};
+
+// Program 0 holds the parameter defaults, so a new instance starts on it:
+static constexpr FROGGPreset FROGGPresets[] =
+{
+    { "Default",            0.5f,  0.5f,  10.0f, 0.5f,  0.5f,  1, 1 },
+    { "Subtle Chorus",      0.35f, 0.4f,  0.8f,  0.5f,  0.1f,  0, 1 },
+    { "Wide Chorus",        0.5f,  0.6f,  1.2f,  0.5f,  0.2f,  0, 3 },
+    { "Ensemble",           0.6f,  0.7f,  0.6f,  0.33f, 0.15f, 0, 6 },
+    { "Vibrato",            1.0f,  0.3f,  5.5f,  0.0f,  0.0f,  0, 1 },
+    { "Jet Flanger",        0.5f,  0.8f,  0.2f,  0.0f,  0.85f, 1, 1 },
+    { "Slow Sweep",         0.5f,  1.0f,  0.1f,  0.5f,  0.6f,  1, 1 },
+    { "Metallic",           0.6f,  0.3f,  4.0f,  0.25f, 0.95f, 1, 2 },
+};
+
+static constexpr int FROGGNumPresets = (int) (sizeof (FROGGPresets) / sizeof (FROGGPresets[0]));
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    Editor view of the LFO, the delay times and the input / output levels.
+
+  ==============================================================================
+*/
+
+#include "FROGGVisualiser.h"
+
+//==============================================================================
+FROGGVisualiser::FROGGVisualiser (FROGGVisualiserFeed& feed)
+    : mFeed(feed),
+      mVBlankAttachment(this, [this] { update(); })
+{
+    setOpaque(true);
+    mFeed.setActive(true);
+}
+
+FROGGVisualiser::~FROGGVisualiser()
+{
+    mFeed.setActive(false);
+}
+
+//==============================================================================
+void FROGGVisualiser::resized()
+{
+    // Level trace on the left, one LFO / delay lane per channel on the right:
+    juce::Rectangle<int> bounds = getLocalBounds().reduced(4);
+    juce::Rectangle<int> lanes = bounds.removeFromRight(bounds.getWidth() / 3);
+
+    mTraceBounds = bounds.withTrimmedRight(6);
+    mLFOBounds[0] = lanes.removeFromTop(lanes.getHeight() / 2);
+    mLFOBounds[1] = lanes;
+
+    renderStaticLayer();
+}
+
+void FROGGVisualiser::renderStaticLayer()
+{
+    if (getWidth() <= 0 || getHeight() <= 0) {
+        return;
+    }
+
+    const float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+
+    mStaticLayer = juce::Image(juce::Image::RGB, juce::roundToInt(getWidth() * scale), juce::roundToInt(getHeight() * scale), true);
+
+    juce::Graphics g(mStaticLayer);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    g.fillAll(juce::Colours::black.withAlpha(0.85f));
+
+    // Level grid every 12 dB:
+    g.setColour(juce::Colours::ghostwhite.withAlpha(0.15f));
+
+    for (float level = 0.0f; level >= -60.0f; level -= 12.0f) {
+        const float y = levelToY(juce::Decibels::decibelsToGain(level, -60.0f));
+        g.drawHorizontalLine(juce::roundToInt(y), (float) mTraceBounds.getX(), (float) mTraceBounds.getRight());
+    }
+
+    // LFO tracks with their centre mark and captions:
+    g.setFont(10.0f);
+
+    for (int channel = 0; channel < 2; channel++) {
+        const juce::Rectangle<int> lane = mLFOBounds[channel];
+        const float trackY = (float) lane.getCentreY();
+
+        g.setColour(juce::Colours::ghostwhite.withAlpha(0.25f));
+        g.drawLine((float) lane.getX(), trackY, (float) lane.getRight(), trackY);
+        g.drawVerticalLine(lane.getCentreX(), trackY - 3.0f, trackY + 3.0f);
+
+        g.setColour(juce::Colours::ghostwhite.withAlpha(0.6f));
+        g.drawText(channel == 0 ? "L" : "R", lane.withHeight(12), juce::Justification::topLeft);
+    }
+
+    g.drawText("IN / OUT", mTraceBounds.withHeight(12), juce::Justification::topLeft);
+}
+
+float FROGGVisualiser::levelToY (float level) const
+{
+    const float decibels = juce::Decibels::gainToDecibels(level, -60.0f);
+    return juce::jmap(decibels, -60.0f, 0.0f, (float) mTraceBounds.getBottom(), (float) mTraceBounds.getY());
+}
+
+//==============================================================================
+void FROGGVisualiser::update()
+{
+    const int numPulled = mFeed.pull(mPulled, FROGGVisualiserFeed::capacity);
+
+    if (numPulled == 0) {
+        return;
+    }
+
+    for (int i = 0; i < numPulled; i++) {
+        mInputHistory[mHistoryHead] = mPulled[i].inputLevel;
+        mOutputHistory[mHistoryHead] = mPulled[i].outputLevel;
+        mHistoryHead = (mHistoryHead + 1) % historySize;
+    }
+
+    mLatest = mPulled[numPulled - 1];
+
+    // Only the areas showing new data are redrawn:
+    repaint(mTraceBounds);
+    repaint(mLFOBounds[0]);
+    repaint(mLFOBounds[1]);
+}
+
+void FROGGVisualiser::paint (juce::Graphics& g)
+{
+    g.drawImage(mStaticLayer, getLocalBounds().toFloat());
+
+    // Level trace, input filled, output as a line, newest on the right:
+    const juce::Rectangle<int> clip = g.getClipBounds();
+
+    if (clip.intersects(mTraceBounds)) {
+        const float xStep = (float) mTraceBounds.getWidth() / (float) (historySize - 1);
+        const float bottom = (float) mTraceBounds.getBottom();
+
+        juce::Path input;
+        juce::Path output;
+        input.preallocateSpace(3 * (historySize + 3));
+        output.preallocateSpace(3 * (historySize + 1));
+
+        input.startNewSubPath((float) mTraceBounds.getX(), bottom);
+
+        for (int i = 0; i < historySize; i++) {
+            const int index = (mHistoryHead + i) % historySize;
+            const float x = (float) mTraceBounds.getX() + (float) i * xStep;
+
+            input.lineTo(x, levelToY(mInputHistory[index]));
+
+            if (i == 0) {
+                output.startNewSubPath(x, levelToY(mOutputHistory[index]));
+            }
+            else {
+                output.lineTo(x, levelToY(mOutputHistory[index]));
+            }
+        }
+
+        input.lineTo((float) mTraceBounds.getRight(), bottom);
+        input.closeSubPath();
+
+        g.setColour(juce::Colours::ghostwhite.withAlpha(0.25f));
+        g.fillPath(input);
+
+        g.setColour(juce::Colours::mediumseagreen);
+        g.strokePath(output, juce::PathStrokeType(1.5f));
+    }
+
+    // LFO position as a dot on its track, delay time below it:
+    g.setFont(10.0f);
+
+    for (int channel = 0; channel < 2; channel++) {
+        const juce::Rectangle<int> lane = mLFOBounds[channel];
+
+        if (! clip.intersects(lane)) {
+            continue;
+        }
+
+        const float x = juce::jmap(mLatest.lfo[channel], -1.0f, 1.0f, (float) lane.getX() + 4.0f, (float) lane.getRight() - 4.0f);
+
+        g.setColour(juce::Colours::mediumpurple);
+        g.fillEllipse(x - 4.0f, (float) lane.getCentreY() - 4.0f, 8.0f, 8.0f);
+
+        g.setColour(juce::Colours::ghostwhite);
+        g.drawText(juce::String(mLatest.delayMs[channel], 2) + " ms", lane.withTrimmedTop(lane.getHeight() - 12),
+                   juce::Justification::centredRight);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    Editor view of the LFO, the delay times and the input / output levels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FROGGVisualiserFeed.h"
+
+//==============================================================================
+/**
+    Shows the live LFO position and delay time of the left and right channels
+    and a scrolling trace of the input and output levels.
+
+    Frames are pulled from the processor's FROGGVisualiserFeed once per display
+    refresh (juce::VBlankAttachment) and only the areas whose data changed are
+    repainted. The grid, scales and captions are drawn once into an image when
+    the size changes, the component is opaque so nothing behind it is redrawn.
+*/
+class FROGGVisualiser : public juce::Component
+{
+public:
+    explicit FROGGVisualiser (FROGGVisualiserFeed& feed);
+    ~FROGGVisualiser() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    // Drains the feed, called on every vertical blank:
+    void update();
+
+    void renderStaticLayer();
+
+    // Level trace height for a peak level, -60..0 dB mapped to the trace area:
+    float levelToY (float level) const;
+
+    //==============================================================================
+    static constexpr int historySize = 256;
+
+    FROGGVisualiserFeed& mFeed;
+    juce::VBlankAttachment mVBlankAttachment;
+
+    juce::Image mStaticLayer;
+    juce::Rectangle<int> mTraceBounds;
+    juce::Rectangle<int> mLFOBounds[2];
+
+    // Level trace, one point per frame, oldest at mHistoryHead:
+    float mInputHistory[historySize] = {};
+    float mOutputHistory[historySize] = {};
+    int mHistoryHead = 0;
+
+    FROGGVisualiserFeed::Frame mLatest {};
+    FROGGVisualiserFeed::Frame mPulled[FROGGVisualiserFeed::capacity];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FROGGVisualiser)
+};
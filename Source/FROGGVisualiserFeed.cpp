@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    Lock-free hand over of modulation and level data from the audio thread
+    to the editor.
+
+  ==============================================================================
+*/
+
+#include "FROGGVisualiserFeed.h"
+
+//==============================================================================
+void FROGGVisualiserFeed::push (const Frame& frame)
+{
+    int start1, size1, start2, size2;
+    mFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0) {
+        mFrames[start1] = frame;
+    }
+
+    mFifo.finishedWrite(size1);
+}
+
+int FROGGVisualiserFeed::pull (Frame* destination, int maxFrames)
+{
+    int start1, size1, start2, size2;
+    mFifo.prepareToRead(maxFrames, start1, size1, start2, size2);
+
+    std::copy(mFrames + start1, mFrames + start1 + size1, destination);
+    std::copy(mFrames + start2, mFrames + start2 + size2, destination + size1);
+
+    mFifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
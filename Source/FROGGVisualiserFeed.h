@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    Lock-free hand over of modulation and level data from the audio thread
+    to the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/FROGGCore.h"
+
+//==============================================================================
+/**
+    Single producer, single consumer ring of visualiser frames.
+
+    The core pushes one Frame per processed chunk on the audio thread, only
+    while an editor is showing it (see setActive), and drops frames when the
+    ring is full; the editor pulls them on the message thread. juce::AbstractFifo
+    keeps both sides free of locks and allocation.
+*/
+class FROGGVisualiserFeed  : public FROGGCore::Monitor
+{
+public:
+    //==============================================================================
+    static constexpr int capacity = 512;
+
+    //==============================================================================
+    // Editors showing the feed, counted so several can open and close in any order:
+    void setActive (bool isActive)      { mNumViewers += isActive ? 1 : -1; }
+    bool isActive() const override      { return mNumViewers.load(std::memory_order_relaxed) > 0; }
+
+    // Audio thread: adds a frame, dropped when the editor falls behind:
+    void push (const Frame& frame) override;
+
+    // Message thread: copies up to maxFrames of the oldest frames, returns how many:
+    int pull (Frame* destination, int maxFrames);
+
+private:
+    //==============================================================================
+    juce::AbstractFifo mFifo { capacity };
+    Frame mFrames[capacity];
+    std::atomic<int> mNumViewers { 0 };
+};
@@ -11,7 +11,7 @@
 
 //==============================================================================
 FROGGAudioProcessorEditor::FROGGAudioProcessorEditor (FROGGAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), mVisualiser (p.getVisualiserFeed())
 {
 
     // Background set up:
@@ -104,6 +104,148 @@ FROGGAudioProcessorEditor::FROGGAudioProcessorEditor (FROGGAudioProcessor& p)
 
     mType.setSelectedItemIndex(*typeParameter);
 
+    // Voices ComboBox set up:
+    AudioParameterInt* voicesParameter = (juce::AudioParameterInt*)params.getUnchecked(6);
+    mVoices.setBounds(15, 85, 80, 20);
+    mVoices.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mVoices.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mVoices.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mVoices.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+
+    for (int voices = 1; voices <= FROGGMaxVoices; voices++) {
+        mVoices.addItem(voices == 1 ? "1 Voice" : juce::String(voices) + " Voices", voices);
+    }
+
+    addAndMakeVisible(mVoices);
+
+    mVoices.onChange = [this, voicesParameter]
+    {
+        voicesParameter->beginChangeGesture();
+        *voicesParameter = mVoices.getSelectedId();
+        voicesParameter->endChangeGesture();
+    };
+
+    mVoices.setSelectedId(*voicesParameter);
+
+    // Interpolation ComboBox set up:
+    AudioParameterChoice* interpolationParameter = (juce::AudioParameterChoice*)params.getUnchecked(7);
+    mInterpolation.setBounds(15, 107, 80, 20);
+    mInterpolation.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mInterpolation.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mInterpolation.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mInterpolation.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+    mInterpolation.addItemList(interpolationParameter->choices, 1);
+    addAndMakeVisible(mInterpolation);
+
+    mInterpolation.onChange = [this, interpolationParameter]
+    {
+        interpolationParameter->beginChangeGesture();
+        *interpolationParameter = mInterpolation.getSelectedItemIndex();
+        interpolationParameter->endChangeGesture();
+    };
+
+    mInterpolation.setSelectedItemIndex(interpolationParameter->getIndex());
+
+    // Oversampling ComboBox set up:
+    AudioParameterChoice* oversamplingParameter = (juce::AudioParameterChoice*)params.getUnchecked(8);
+    mOversampling.setBounds(15, 129, 80, 20);
+    mOversampling.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mOversampling.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mOversampling.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mOversampling.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+    mOversampling.addItemList(oversamplingParameter->choices, 1);
+    addAndMakeVisible(mOversampling);
+
+    mOversampling.onChange = [this, oversamplingParameter]
+    {
+        oversamplingParameter->beginChangeGesture();
+        *oversamplingParameter = mOversampling.getSelectedItemIndex();
+        oversamplingParameter->endChangeGesture();
+    };
+
+    mOversampling.setSelectedItemIndex(oversamplingParameter->getIndex());
+
+    // LFO Sync ComboBox set up:
+    AudioParameterChoice* lfoSyncParameter = (juce::AudioParameterChoice*)params.getUnchecked(9);
+    mLFOSync.setBounds(15, 151, 80, 20);
+    mLFOSync.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mLFOSync.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mLFOSync.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mLFOSync.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+    mLFOSync.addItemList(lfoSyncParameter->choices, 1);
+    addAndMakeVisible(mLFOSync);
+
+    mLFOSync.onChange = [this, lfoSyncParameter]
+    {
+        lfoSyncParameter->beginChangeGesture();
+        *lfoSyncParameter = mLFOSync.getSelectedItemIndex();
+        lfoSyncParameter->endChangeGesture();
+    };
+
+    mLFOSync.setSelectedItemIndex(lfoSyncParameter->getIndex());
+
+    // Program ComboBox set up, the factory presets:
+    mProgram.setBounds(15, 173, 80, 20);
+    mProgram.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mProgram.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mProgram.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mProgram.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+
+    for (int program = 0; program < audioProcessor.getNumPrograms(); program++) {
+        mProgram.addItem(audioProcessor.getProgramName(program), program + 1);
+    }
+
+    addAndMakeVisible(mProgram);
+
+    mProgram.onChange = [this]
+    {
+        audioProcessor.setCurrentProgram(mProgram.getSelectedItemIndex());
+    };
+
+    mProgram.setSelectedItemIndex(audioProcessor.getCurrentProgram(), juce::dontSendNotification);
+
+    // Quality ComboBox set up, every tier with its CPU cost against Standard:
+    AudioParameterChoice* qualityParameter = (juce::AudioParameterChoice*)params.getUnchecked(10);
+    mQuality.setBounds(15, 195, 80, 20);
+    mQuality.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mQuality.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mQuality.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mQuality.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+
+    for (int tier = 0; tier < FROGGNumQualityTiers; tier++) {
+        mQuality.addItem(juce::String(FROGGQualityTiers[tier].name) + " " + juce::String(FROGGQualityTiers[tier].relativeCost, 2) + "x", tier + 1);
+    }
+
+    addAndMakeVisible(mQuality);
+
+    mQuality.onChange = [this, qualityParameter]
+    {
+        qualityParameter->beginChangeGesture();
+        *qualityParameter = mQuality.getSelectedItemIndex();
+        qualityParameter->endChangeGesture();
+    };
+
+    mQuality.setSelectedItemIndex(qualityParameter->getIndex());
+
+    // Rate Reduction ComboBox set up, only reduces at 88.2 kHz and above:
+    AudioParameterChoice* rateReductionParameter = (juce::AudioParameterChoice*)params.getUnchecked(11);
+    mRateReduction.setBounds(15, 217, 80, 20);
+    mRateReduction.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+    mRateReduction.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    mRateReduction.setColour(juce::ComboBox::arrowColourId, juce::Colours::ghostwhite);
+    mRateReduction.setColour(juce::ComboBox::textColourId, juce::Colours::ghostwhite);
+    mRateReduction.addItemList(rateReductionParameter->choices, 1);
+    addAndMakeVisible(mRateReduction);
+
+    mRateReduction.onChange = [this, rateReductionParameter]
+    {
+        rateReductionParameter->beginChangeGesture();
+        *rateReductionParameter = mRateReduction.getSelectedItemIndex();
+        rateReductionParameter->endChangeGesture();
+    };
+
+    mRateReduction.setSelectedItemIndex(rateReductionParameter->getIndex());
+
     // Slider colors:
     mDryWetSlider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::ghostwhite);
     mDryWetSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colours::whitesmoke);
@@ -125,12 +267,25 @@ FROGGAudioProcessorEditor::FROGGAudioProcessorEditor (FROGGAudioProcessor& p)
     mFeedbackSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colours::rebeccapurple);
     mFeedbackSlider.setColour(juce::Slider::thumbColourId, juce::Colours::lightseagreen);
 
+    // Visualiser set up, under the knobs:
+    mVisualiser.setBounds(110, 185, 275, 85);
+    addAndMakeVisible(mVisualiser);
+
+    // CPU load Label set up, refreshed from the load meter a few times a second:
+    mLoadLabel.setBounds(15, 275, 250, 18);
+    mLoadLabel.setColour(juce::Label::textColourId, juce::Colours::ghostwhite);
+    mLoadLabel.setFont(12.0f);
+    addAndMakeVisible(mLoadLabel);
+
+    startTimerHz(10);
+    timerCallback();
+
     setSize(400, 300);
 }
 
 FROGGAudioProcessorEditor::~FROGGAudioProcessorEditor()
 {
-
+    stopTimer();
 }
 
 //==============================================================================
@@ -144,6 +299,34 @@ void FROGGAudioProcessorEditor::paint (juce::Graphics& g)
     g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);*/
 }
 
+void FROGGAudioProcessorEditor::timerCallback()
+{
+    // Program changes, host automation and loaded states move the controls too:
+    auto& params = processor.getParameters();
+
+    mDryWetSlider.setValue(*(juce::AudioParameterFloat*)params.getUnchecked(0), juce::dontSendNotification);
+    mDepthSlider.setValue(*(juce::AudioParameterFloat*)params.getUnchecked(1), juce::dontSendNotification);
+    mRateSlider.setValue(*(juce::AudioParameterFloat*)params.getUnchecked(2), juce::dontSendNotification);
+    mPhaseOffsetSlider.setValue(*(juce::AudioParameterFloat*)params.getUnchecked(3), juce::dontSendNotification);
+    mFeedbackSlider.setValue(*(juce::AudioParameterFloat*)params.getUnchecked(4), juce::dontSendNotification);
+    mType.setSelectedItemIndex(*(juce::AudioParameterInt*)params.getUnchecked(5), juce::dontSendNotification);
+    mVoices.setSelectedId(*(juce::AudioParameterInt*)params.getUnchecked(6), juce::dontSendNotification);
+    mInterpolation.setSelectedItemIndex(((juce::AudioParameterChoice*)params.getUnchecked(7))->getIndex(), juce::dontSendNotification);
+    mOversampling.setSelectedItemIndex(((juce::AudioParameterChoice*)params.getUnchecked(8))->getIndex(), juce::dontSendNotification);
+    mLFOSync.setSelectedItemIndex(((juce::AudioParameterChoice*)params.getUnchecked(9))->getIndex(), juce::dontSendNotification);
+    mProgram.setSelectedItemIndex(audioProcessor.getCurrentProgram(), juce::dontSendNotification);
+    mQuality.setSelectedItemIndex(((juce::AudioParameterChoice*)params.getUnchecked(10))->getIndex(), juce::dontSendNotification);
+    mRateReduction.setSelectedItemIndex(((juce::AudioParameterChoice*)params.getUnchecked(11))->getIndex(), juce::dontSendNotification);
+
+    // Only atomics are read, the audio thread never waits for the editor:
+    FROGGLoadMeter& loadMeter = audioProcessor.getLoadMeter();
+
+    mLoadLabel.setText("CPU " + juce::String(roundToInt(loadMeter.getLoad() * 100.0f)) + "%"
+                       + "  Peak " + juce::String(roundToInt(loadMeter.getPeakLoad() * 100.0f)) + "%"
+                       + "  Overruns " + juce::String(loadMeter.getNumOverruns()),
+                       juce::dontSendNotification);
+}
+
 void FROGGAudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
@@ -10,11 +10,13 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "FROGGVisualiser.h"
 
 //==============================================================================
 /**
 */
-class FROGGAudioProcessorEditor  :public juce::AudioProcessorEditor
+class FROGGAudioProcessorEditor  :public juce::AudioProcessorEditor,
+                                   private juce::Timer
 {
 public:
     FROGGAudioProcessorEditor (FROGGAudioProcessor&);
@@ -25,6 +27,9 @@ public:
     void resized() override;
 
 private:
+    // Polls the processor's load meter and the parameters the host or a program change may set:
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     FROGGAudioProcessor& audioProcessor;
@@ -47,6 +52,33 @@ private:
     // Combobox for Flanger / Chorus:
     ComboBox mType;
 
+    // Combobox for the number of ensemble voices:
+    ComboBox mVoices;
+
+    // Combobox for the interpolation of the delayed signal:
+    ComboBox mInterpolation;
+
+    // Combobox for the oversampling factor of the delay:
+    ComboBox mOversampling;
+
+    // Combobox for the LFO sync: free running, playhead or tempo:
+    ComboBox mLFOSync;
+
+    // Combobox for the factory presets:
+    ComboBox mProgram;
+
+    // Combobox for the quality tier:
+    ComboBox mQuality;
+
+    // Combobox for the internal rate reduction of the wet path:
+    ComboBox mRateReduction;
+
+    // LFO, delay times and level trace:
+    FROGGVisualiser mVisualiser;
+
+    // CPU load, peak and overruns of the audio callback:
+    Label mLoadLabel;
+
     // Background:
     juce::ImageComponent background;
 
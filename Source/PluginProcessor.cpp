@@ -11,6 +11,23 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "FROGGJUCEOversampler.h"
+#include "DSP/FROGGTrace.h"
+
+//==============================================================================
+namespace
+{
+    // Binary state: stateMagic, the version, the current program, the number of values and the
+    // normalised value of every parameter in index order, all little endian. Parameters are only
+    // ever appended, so a newer version adds fields after these: an older state leaves the parameters
+    // it lacks alone, and values a newer one appends are skipped.
+    // Version 2 appended Auto to the interpolation choices, which moved their normalised values.
+    constexpr int stateMagic = 0x474f5246;  // "FROG"
+    constexpr int stateVersion = 2;
+
+    // Interpolation choices before version 2, Linear to Sinc:
+    constexpr int numVersion1Interpolations = 4;
+}
 
 //==============================================================================
 FROGGAudioProcessor::FROGGAudioProcessor()
@@ -63,22 +80,73 @@ FROGGAudioProcessor::FROGGAudioProcessor()
         1,
         1));
 
-    // Circular buffer and related variables initialization
-    mCircularBufferLeft = nullptr;
-    mCircularBufferRight = nullptr;
-    mCircularBufferWriteHead = 0;
-    mCircularBufferLenght = 0;
-
-    // Feedback variables initialization
-    mFeedbackLeft = 0;
-    mFeedbackRight = 0;
+    addParameter(mVoicesParameter = new juce::AudioParameterInt("voices",
+        "Voices",
+        1,
+        FROGGMaxVoices,
+        1));
 
-    // LFO phase initialization
-    mLFOPhase = 0;
+    addParameter(mInterpolationParameter = new juce::AudioParameterChoice("interpolation",
+        "Interpolation",
+        { "Linear", "Hermite", "Lagrange", "Sinc", "Auto" },
+        (int) FROGGInterpolation::linear));
+
+    addParameter(mOversamplingParameter = new juce::AudioParameterChoice("oversampling",
+        "Oversampling",
+        { "Off", "2x", "4x" },
+        0));
+
+    addParameter(mLFOSyncParameter = new juce::AudioParameterChoice("lfosync",
+        "LFO Sync",
+        { "Free", "Playhead", "Tempo" },
+        0));
+
+    addParameter(mQualityParameter = new juce::AudioParameterChoice("quality",
+        "Quality",
+        { "Eco", "Standard", "High", "Ultra" },
+        FROGGDefaultQualityTier));
+
+    addParameter(mRateReductionParameter = new juce::AudioParameterChoice("ratereduction",
+        "Rate Reduction",
+        { "Full Rate", "Reduced" },
+        0));
+
+    // Channel count until prepareToPlay knows the real layout
+    mNumChannels = 2;
+
+    // The LFO runs free until a playing host syncs it
+    mLFOSyncMode = 0;
+    mNextPlayheadPosition = 0;
+
+    // The core oversamples through the JUCE filters and feeds the editor's visualiser
+    mCore.setOversamplerFactory(this);
+    mCore.setMonitor(&mVisualiserFeed);
+
+    // Starts on the default preset, applied directly until prepareToPlay
+    mCurrentProgram = 0;
+    mPendingProgram = -1;
+    mSwitchingProgram = -1;
+    mProgramChanged = false;
+    mIsPrepared = false;
+
+   #if FROGG_ENABLE_TRACING
+    // Tracing builds record every instance of the process into one file in the temp folder:
+    const juce::String traceName = "FROGG-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json";
+    FROGGTrace::startSession(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile(traceName).getFullPathName().toStdString());
+   #endif
 }
 
 FROGGAudioProcessor::~FROGGAudioProcessor()
 {
+    // No notification may arrive once the processor is gone:
+    cancelPendingUpdate();
+
+    // Delay memory goes back to the shared pool for the next instance:
+    mCore.release();
+
+   #if FROGG_ENABLE_TRACING
+    FROGGTrace::stopSession();
+   #endif
 }
 
 //==============================================================================
@@ -116,81 +184,174 @@ bool FROGGAudioProcessor::isMidiEffect() const
 
 double FROGGAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The oversampling or rate reduction filters delay the tail as well:
+    const double sampleRate = getSampleRate();
+    const double latencySeconds = sampleRate > 0.0 ? getLatencySamples() / sampleRate : 0.0;
+
+    return FROGGCore::computeTailSeconds(*mFeedbackParameter, *mTypeParameter) + latencySeconds;
 }
 
 int FROGGAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return FROGGNumPresets;
 }
 
 int FROGGAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return mCurrentProgram;
 }
 
 void FROGGAudioProcessor::setCurrentProgram (int index)
 {
+    if (! isPositiveAndBelow(index, FROGGNumPresets))
+        return;
+
+    // While processing, the audio thread picks the change up and crossfades to it:
+    if (mIsPrepared) {
+        mPendingProgram = index;
+        return;
+    }
+
+    setPresetValues(FROGGPresets[index], true);
+    mCurrentProgram = index;
 }
 
 const juce::String FROGGAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return isPositiveAndBelow(index, FROGGNumPresets) ? juce::String(FROGGPresets[index].name) : juce::String();
 }
 
 void FROGGAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    // Factory presets keep their names
 }
 
-//==============================================================================
-void FROGGAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+void FROGGAudioProcessor::setPresetValues (const FROGGPreset& preset, bool notifyHost)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
+    const std::pair<juce::RangedAudioParameter*, float> values[] = {
+        { mDryWetParameter, preset.dryWet },
+        { mDepthParameter, preset.depth },
+        { mRateParameter, preset.rate },
+        { mPhaseOffsetParameter, preset.phaseOffset },
+        { mFeedbackParameter, preset.feedback },
+        { mTypeParameter, (float) preset.type },
+        { mVoicesParameter, (float) preset.voices }
+    };
+
+    for (const auto& value : values) {
+        const float normalisedValue = value.first->convertTo0to1(value.second);
+
+        if (notifyHost) {
+            value.first->setValueNotifyingHost(normalisedValue);
+        }
+        else {
+            value.first->setValue(normalisedValue);
+        }
+    }
+}
 
-    mDelayTimeSmoothed = 1;
+void FROGGAudioProcessor::updateProgramChange()
+{
+    const int program = mPendingProgram.exchange(-1);
+
+    if (program >= 0) {
+        mSwitchingProgram = program;
+        mCore.setWetMuted(true);
+    }
+
+    if (mSwitchingProgram < 0 || ! mCore.isWetMuted())
+        return;
 
-    // Reset Phase:
-    mLFOPhase = 0;
+    // Only the dry signal is heard now, the new values take over and fade in with the smoothers:
+    setPresetValues(FROGGPresets[mSwitchingProgram], false);
+    mCurrentProgram = mSwitchingProgram;
+    mSwitchingProgram = -1;
+    mCore.setWetMuted(false);
 
-    // Circular buffer length calculation based on maximum delay time (2):
-    mCircularBufferLenght = sampleRate * MAX_DELAY_TIME;
+    mProgramChanged = true;
+    triggerAsyncUpdate();
+}
 
-    // Release existing memory for circular buffers if any:
-    if (mCircularBufferLeft != nullptr) {
-        delete[] mCircularBufferLeft;
-        mCircularBufferLeft = nullptr;
+void FROGGAudioProcessor::handleAsyncUpdate()
+{
+    // The float engine keeps running meanwhile, the core switches once this is done:
+    if (mIsPrepared && FROGGQualityTiers[mQualityParameter->getIndex()].doublePrecision) {
+        mCore.prepareDoubleEngine();
     }
 
-    if (mCircularBufferRight != nullptr) {
-        delete[] mCircularBufferRight;
-        mCircularBufferRight = nullptr;
+    // The host compensates for the latency the core moved to during process:
+    if (mCore.checkLatencyChanged()) {
+        setLatencySamples(mCore.getLatencySamples());
     }
 
-    // Allocate memory for circular buffers:
-    if (mCircularBufferLeft == nullptr) {
-        mCircularBufferLeft = new float[mCircularBufferLenght];
+    if (! mProgramChanged.exchange(false))
+        return;
+
+    juce::AudioProcessorParameter* const presetParameters[] = { mDryWetParameter, mDepthParameter, mRateParameter, mPhaseOffsetParameter,
+                                                                mFeedbackParameter, mTypeParameter, mVoicesParameter };
+
+    for (auto* parameter : presetParameters) {
+        parameter->sendValueChangedMessageToListeners(parameter->getValue());
     }
 
-    // Initialize circular buffer with zeros:
-    zeromem(mCircularBufferLeft, mCircularBufferLenght * sizeof(float));
+    updateHostDisplay();
+}
+
+//==============================================================================
+void FROGGAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // Use this method as the place to do any pre-playback
+    // initialisation that you need..
+
+    // Timed changes queued for the previous stream no longer line up:
+    mParameterEvents.clear();
 
+    // A program change still fading is applied straight away:
+    const int pendingProgram = mPendingProgram.exchange(-1);
+    const int program = pendingProgram >= 0 ? pendingProgram : mSwitchingProgram;
 
-    if (mCircularBufferRight == nullptr) {
-        mCircularBufferRight = new float[mCircularBufferLenght];
+    if (program >= 0) {
+        setPresetValues(FROGGPresets[program], false);
+        mCurrentProgram = program;
+        mSwitchingProgram = -1;
+        mProgramChanged = true;
+        triggerAsyncUpdate();
     }
 
-    zeromem(mCircularBufferRight, mCircularBufferLenght * sizeof(float));
-    
-    // Circular buffer write head reset:
-    mCircularBufferWriteHead = 0;
+    // Load statistics for the new rate and block size:
+    mLoadMeter.prepare(sampleRate, samplesPerBlock);
+
+    // Every channel the host negotiated, each one a lane of the delay kernels. The core holds memory
+    // in the precision the host processes in, and in double too for a double precision tier:
+    mNumChannels = jlimit(1, FROGGMaxChannels, getTotalNumOutputChannels());
+    mCore.prepare(sampleRate, mNumChannels, jmax(1, samplesPerBlock), isUsingDoublePrecision(), getParameterSnapshot());
+
+    // The core's LFO starts free, the first block played syncs it again:
+    mLFOSyncMode = 0;
+
+    // The oversampling and rate reduction filters delay the signal, the host compensates for it:
+    setLatencySamples(mCore.getLatencySamples());
+
+    mIsPrepared = true;
 }
 
 void FROGGAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    mIsPrepared = false;
+    mCore.release();
+}
+
+//==============================================================================
+std::unique_ptr<FROGGOversampler<float>> FROGGAudioProcessor::createFloat (int factor, int numChannels, int maxBlockSize)
+{
+    return std::make_unique<FROGGJUCEOversampler<float>>(factor, numChannels, maxBlockSize);
+}
+
+std::unique_ptr<FROGGOversampler<double>> FROGGAudioProcessor::createDouble (int factor, int numChannels, int maxBlockSize)
+{
+    return std::make_unique<FROGGJUCEOversampler<double>>(factor, numChannels, maxBlockSize);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -200,12 +361,11 @@ bool FROGGAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any channel set works, from mono up to FROGGMaxChannels (e.g. 7.1.4),
+    // every channel is processed as one lane of the delay kernels.
+    const int numChannels = layouts.getMainOutputChannelSet().size();
+
+    if (layouts.getMainOutputChannelSet().isDisabled() || numChannels > FROGGMaxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -220,10 +380,25 @@ bool FROGGAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 #endif
 
 void FROGGAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void FROGGAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+template <typename SampleType>
+void FROGGAudioProcessor::process (juce::AudioBuffer<SampleType>& buffer)
 {
     // ScopedNoDenormals ensures that denormalized numbers won't cause performance issues
     juce::ScopedNoDenormals noDenormals;
 
+    // Times the whole block, up to every return:
+    const FROGGLoadMeter::ScopedBlock loadTimer(mLoadMeter, buffer.getNumSamples());
+    FROGG_TRACE_ZONE("processBlock");
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -231,123 +406,220 @@ void FROGGAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get pointers to the left and right channels of the audio buffer
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = buffer.getWritePointer(1);
+    // No delay memory until prepareToPlay, or after releaseResources:
+    if (! mCore.isPrepared())
+        return;
 
-    // Process each sample in the buffer
-    for (int i = 0; i < buffer.getNumSamples(); i++) {
+    // Channels prepared in prepareToPlay that the buffer actually holds:
+    const int numChannels = jmin(mNumChannels, buffer.getNumChannels());
+    SampleType* const* channelData = buffer.getArrayOfWritePointers();
+    SampleType* channels[FROGGMaxChannels];
 
-        // Circular buffer write operation with feedback
-        mCircularBufferLeft[mCircularBufferWriteHead] = leftChannel[i] + mFeedbackLeft;
-        mCircularBufferRight[mCircularBufferWriteHead] = rightChannel[i] + mFeedbackRight;
+    const int numSamples = buffer.getNumSamples();
 
-        // LFO phase calculation and normalization
-        float lfoOutLeft = sin(2 * M_PI * mLFOPhase);
-        float lfoPhaseRight = mLFOPhase + *mPhaseOffsetParameter;
+    // A requested program change fades the wet signal out first:
+    updateProgramChange();
 
-        if (lfoPhaseRight > 1) {
-            lfoPhaseRight -= 1;
-        }
+    // Read every parameter once for the whole block. Same position, same modulation, whatever was
+    // processed before:
+    FROGGCore::Parameters snapshot = getParameterSnapshot();
+    syncLFOToPlayhead(snapshot, numSamples);
+    mCore.setParameters(snapshot);
 
-        float lfoOutRight = sin(2 * M_PI * lfoPhaseRight);
+    // A float host on a double precision tier needs the core's double engine, allocated on the message thread:
+    if (mCore.needsDoubleEngine()) {
+        triggerAsyncUpdate();
+    }
 
-        // Update LFO phase
-        mLFOPhase += *mRateParameter / getSampleRate();
+    if (mParameterEvents.isEmpty()) {
+        mCore.process(channelData, numChannels, numSamples);
+    }
+    else {
+        // Timed changes split the block only where they land, the kernels run unchanged in between. They
+        // override the snapshot for the rest of the block, the parameters themselves belong to the host.
+        // The full path renders them, also on silent input:
+        mParameterEvents.sort();
+        mCore.wakeUp();
 
-        if (mLFOPhase > 1) {
-            mLFOPhase -= 1;
-        }
+        int segmentStart = 0;
+        int numUsed = 0;
 
-        // Apply depth parameter to LFO output
-        lfoOutLeft *= *mDepthParameter;
-        lfoOutRight *= *mDepthParameter;
+        while (segmentStart < numSamples) {
 
-        // Map LFO output to a specified range based on the type parameter
-        float lfoOutMappedLeft = 0;
-        float lfoOutMappedRight = 0;
+            // Every event up to this sample applies from here on:
+            while (numUsed < mParameterEvents.size() && mParameterEvents[numUsed].sampleOffset <= segmentStart) {
+                const FROGGParameterEvents::Event& event = mParameterEvents[numUsed++];
+                applyParameterEvent(snapshot, event.parameterIndex, event.value);
+            }
 
-        if (*mTypeParameter == 0) {
-            // Chorus:
-            lfoOutMappedLeft = jmap(lfoOutLeft, -1.f, 1.f, 0.005f, 0.03f);
-            lfoOutMappedRight = jmap(lfoOutRight, -1.f, 1.f, 0.005f, 0.03f);
-        }
-        else {
-            // Flanger:
-            lfoOutMappedLeft = jmap(lfoOutLeft, -1.f, 1.f, 0.001f, 0.005f);
-            lfoOutMappedRight = jmap(lfoOutRight, -1.f, 1.f, 0.001f, 0.005f);
-        }
+            if (numUsed > 0) {
+                mCore.setParameters(snapshot);
+            }
 
-        // Calculate delay time in samples based on LFO output
-        float delayTimeSamplesLeft = getSampleRate() * lfoOutMappedLeft;
-        float delayTimeSamplesRight = getSampleRate() * lfoOutMappedRight;
+            const int segmentEnd = numUsed < mParameterEvents.size() ? jmin(numSamples, mParameterEvents[numUsed].sampleOffset)
+                                                                     : numSamples;
 
-        // Calculate read heads for left and right channels
-        float delayReadHeadLeft = mCircularBufferWriteHead - delayTimeSamplesLeft;
-        float delayReadHeadRight = mCircularBufferWriteHead - delayTimeSamplesRight;
+            for (int channel = 0; channel < numChannels; channel++) {
+                channels[channel] = channelData[channel] + segmentStart;
+            }
 
-        // Make sure they never get to less than 0:
-        if (delayReadHeadLeft < 0) {
-            delayReadHeadLeft += mCircularBufferLenght;
+            mCore.process(channels, numChannels, segmentEnd - segmentStart);
+            segmentStart = segmentEnd;
         }
 
-        if (delayReadHeadRight < 0) {
-            delayReadHeadRight += mCircularBufferLenght;
-        }
+        // Events past this block wait for the next one:
+        mParameterEvents.removeFirst(numUsed, numSamples);
+    }
 
-        // Convert read head positions to integer and fractional parts
-        int readHeadLeft_x = (int)delayReadHeadLeft;
-        int readHeadLeft_x1 = readHeadLeft_x + 1;
-        float readHeadFloatLeft = delayReadHeadLeft - readHeadLeft_x;
+    // Oversampling and rate reduction changes move the latency, the host hears about it from the message thread:
+    if (mCore.isLatencyChangePending()) {
+        triggerAsyncUpdate();
+    }
+}
 
-        int readHeadRight_x = (int)delayReadHeadRight;
-        int readHeadRight_x1 = readHeadRight_x + 1;
-        float readHeadFloatRight = delayReadHeadRight - readHeadRight_x;
+void FROGGAudioProcessor::syncLFOToPlayhead (FROGGCore::Parameters& snapshot, int numSamples)
+{
+    const int mode = mLFOSyncParameter->getIndex();
+    juce::AudioPlayHead* playHead = getPlayHead();
 
-        if (readHeadLeft_x1 >= mCircularBufferLenght) {
-            readHeadLeft_x1 -= mCircularBufferLenght;
+    // Free: the LFO runs on from the phase it reached:
+    if (mode == 0 || playHead == nullptr) {
+        if (mCore.isLFOOnTimeline()) {
+            mCore.releaseLFOFromTimeline();
         }
 
-        if (readHeadRight_x1 >= mCircularBufferLenght) {
-            readHeadRight_x1 -= mCircularBufferLenght;
-        }
+        mLFOSyncMode = 0;
+        return;
+    }
+
+    const juce::Optional<juce::AudioPlayHead::PositionInfo> position = playHead->getPosition();
+
+    // Stopped transports keep reporting the same position, the LFO runs on meanwhile and syncs
+    // again once playback starts:
+    if (! position.hasValue() || ! position->getIsPlaying()) {
+        mLFOSyncMode = 0;
+        return;
+    }
 
-        // Perform linear interpolation to get delayed samples
-        float delay_sample_left = lin_interp(mCircularBufferLeft[readHeadLeft_x], mCircularBufferLeft[readHeadLeft_x1], readHeadFloatLeft);
-        float delay_sample_right = lin_interp(mCircularBufferRight[readHeadRight_x], mCircularBufferRight[readHeadRight_x1], readHeadFloatRight);
+    double phase;
+    juce::int64 samplePosition;
 
-        // Apply feedback to the delayed samples
-        mFeedbackLeft = delay_sample_left * *mFeedbackParameter;
-        mFeedbackRight = delay_sample_right * *mFeedbackParameter;
+    if (mode == 1) {
+        // Playhead: cycles since sample 0 of the timeline at the rate parameter:
+        const juce::Optional<juce::int64> timeInSamples = position->getTimeInSamples();
 
-        // Increment circular buffer write head with wrap-around
-        mCircularBufferWriteHead++;
+        if (! timeInSamples.hasValue()) {
+            mLFOSyncMode = 0;
+            return;
+        }
 
-        if (mCircularBufferWriteHead >= mCircularBufferLenght) {
-            mCircularBufferWriteHead = 0;
+        samplePosition = *timeInSamples;
+        phase = (double) samplePosition * snapshot.rate / mCore.getSampleRate();
+    }
+    else {
+        // Tempo: the rate is rounded to a power of two cycles per beat, counted from the start of the song,
+        // so the LFO stays locked to bars and beats through tempo changes:
+        const juce::Optional<double> ppq = position->getPpqPosition();
+        const juce::Optional<double> bpm = position->getBpm();
+
+        if (! ppq.hasValue() || ! bpm.hasValue() || *bpm <= 0.0) {
+            mLFOSyncMode = 0;
+            return;
         }
 
-        // Calculate dry and wet amounts based on the dry/wet parameter
-        float dryAmount = 1 - *mDryWetParameter;
-        float wetAmount = *mDryWetParameter;
+        const double cyclesPerBeat = std::exp2(std::round(std::log2(snapshot.rate * 60.0 / *bpm)));
+        snapshot.rate = (float) (cyclesPerBeat * *bpm / 60.0);
+        phase = *ppq * cyclesPerBeat;
+
+        // The timeline's samples, or the beats at this tempo:
+        const juce::Optional<juce::int64> timeInSamples = position->getTimeInSamples();
+        samplePosition = timeInSamples.hasValue() ? *timeInSamples : (juce::int64) std::llround(*ppq * 60.0 / *bpm * mCore.getSampleRate());
+    }
 
-        // Apply the delay effect to the output buffer
-        buffer.setSample(0, i, buffer.getSample(0, i) * dryAmount + delay_sample_left * wetAmount);
-        buffer.setSample(1, i, buffer.getSample(1, i) * dryAmount + delay_sample_right * wetAmount);
+    // Only the start of playback, a jump of the playhead or another mode moves the LFO. In between
+    // the core works its phase out from the samples played, rounded the same whatever the blocks:
+    if (mode != mLFOSyncMode || samplePosition != mNextPlayheadPosition) {
+        mCore.syncLFOToTimeline(phase, samplePosition);
+        mLFOSyncMode = mode;
     }
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
+    mNextPlayheadPosition = samplePosition + numSamples;
+}
+
+double FROGGAudioProcessor::getPrerollSeconds() const
+{
+    // Anything older than a tail has died away below the threshold:
+    return getTailLengthSeconds();
+}
+
+bool FROGGAudioProcessor::queueParameterChange (int parameterIndex, float value, int sampleOffset)
+{
+    return mParameterEvents.add(sampleOffset, parameterIndex, value);
+}
+
+void FROGGAudioProcessor::applyParameterEvent (FROGGCore::Parameters& snapshot, int parameterIndex, float value) const
+{
+    const auto& parameters = getParameters();
+
+    if (! isPositiveAndBelow(parameterIndex, parameters.size()))
+        return;
 
-        // ..do something to the data...
+    // The same conversion from the normalised value as the parameter would make, without setting it.
+    // LFO sync is not part of the snapshot, it is read once per block, and Tempo sync sets the rate:
+    const juce::AudioProcessorParameter* parameter = parameters.getUnchecked(parameterIndex);
+
+    if (parameter == mDryWetParameter) {
+        snapshot.dryWet = mDryWetParameter->convertFrom0to1(value);
+    }
+    else if (parameter == mDepthParameter) {
+        snapshot.depth = mDepthParameter->convertFrom0to1(value);
+    }
+    else if (parameter == mRateParameter && mLFOSyncMode != 2) {
+        snapshot.rate = mRateParameter->convertFrom0to1(value);
+    }
+    else if (parameter == mPhaseOffsetParameter) {
+        snapshot.phaseOffset = mPhaseOffsetParameter->convertFrom0to1(value);
+    }
+    else if (parameter == mFeedbackParameter) {
+        snapshot.feedback = mFeedbackParameter->convertFrom0to1(value);
+    }
+    else if (parameter == mTypeParameter) {
+        snapshot.type = roundToInt(mTypeParameter->convertFrom0to1(value));
     }
+    else if (parameter == mVoicesParameter) {
+        snapshot.voices = roundToInt(mVoicesParameter->convertFrom0to1(value));
+    }
+    else if (parameter == mInterpolationParameter) {
+        snapshot.interpolation = roundToInt(mInterpolationParameter->convertFrom0to1(value));
+    }
+    else if (parameter == mQualityParameter) {
+        snapshot.quality = roundToInt(mQualityParameter->convertFrom0to1(value));
+    }
+    else if (parameter == mOversamplingParameter) {
+        snapshot.oversamplingFactor = 1 << roundToInt(mOversamplingParameter->convertFrom0to1(value));
+    }
+    else if (parameter == mRateReductionParameter) {
+        snapshot.rateReduction = roundToInt(mRateReductionParameter->convertFrom0to1(value)) == 1;
+    }
+}
+
+FROGGCore::Parameters FROGGAudioProcessor::getParameterSnapshot() const
+{
+    FROGG_TRACE_ZONE("Parameter read");
+
+    FROGGCore::Parameters snapshot;
+    snapshot.dryWet = *mDryWetParameter;
+    snapshot.depth = *mDepthParameter;
+    snapshot.rate = *mRateParameter;
+    snapshot.phaseOffset = *mPhaseOffsetParameter;
+    snapshot.feedback = *mFeedbackParameter;
+    snapshot.type = *mTypeParameter;
+    snapshot.voices = *mVoicesParameter;
+    snapshot.interpolation = mInterpolationParameter->getIndex();
+    snapshot.quality = mQualityParameter->getIndex();
+    snapshot.oversamplingFactor = 1 << mOversamplingParameter->getIndex();
+    snapshot.rateReduction = mRateReductionParameter->getIndex() == 1;
+    return snapshot;
 }
 
 //==============================================================================
@@ -364,29 +636,83 @@ juce::AudioProcessorEditor* FROGGAudioProcessor::createEditor()
 //==============================================================================
 void FROGGAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    std::unique_ptr<XmlElement> xml(new XmlElement("FlangerChorus"));
-    xml->setAttribute("DryWet", *mDryWetParameter);
-    xml->setAttribute("Depth", *mDepthParameter);
-    xml->setAttribute("Rate", *mRateParameter);
-    xml->setAttribute("PhaseOffset", *mPhaseOffsetParameter);
-    xml->setAttribute("Feedback", *mFeedbackParameter);
-    xml->setAttribute("Type", *mTypeParameter);
-    copyXmlToBinary(*xml, destData);
+    auto& parameters = getParameters();
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    stream.writeInt(mCurrentProgram);
+    stream.writeInt(parameters.size());
+
+    for (auto* parameter : parameters) {
+        stream.writeFloat(parameter->getValue());
+    }
 }
 
 void FROGGAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+    juce::MemoryInputStream stream(data, (size_t) sizeInBytes, false);
+
+    if (sizeInBytes < 16 || stream.readInt() != stateMagic) {
+        // Sessions saved before the binary format hold the FlangerChorus XML:
+        std::unique_ptr<XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+
+        if (xml.get() != nullptr) {
+            setStateFromXml(*xml);
+        }
+
+        return;
+    }
 
-    if (xml.get() != nullptr && xml->hasTagName("FlangerChorus")) {
-        *mDryWetParameter = xml->getDoubleAttribute("DryWet");
-        *mDepthParameter = xml->getDoubleAttribute("Depth");
-        *mRateParameter = xml->getDoubleAttribute("Rate");
-        *mPhaseOffsetParameter = xml->getDoubleAttribute("PhaseOffset");
-        *mFeedbackParameter = xml->getDoubleAttribute("Feedback");
-        *mTypeParameter = xml->getIntAttribute("Type");
+    // Every version starts with the version 1 fields:
+    const int version = stream.readInt();
+
+    if (version < 1)
+        return;
+
+    const int program = stream.readInt();
+    const int numValues = stream.readInt();
+    auto& parameters = getParameters();
+
+    // Version 1 has no quality, it keeps the sound it was saved with:
+    if (version < 2) {
+        mQualityParameter->setValueNotifyingHost(mQualityParameter->convertTo0to1((float) FROGGLegacyQualityTier));
+    }
+
+    for (int i = 0; i < numValues && stream.getNumBytesRemaining() >= (juce::int64) sizeof (float); i++) {
+        const float value = stream.readFloat();
+
+        if (i < parameters.size() && std::isfinite(value)) {
+            float normalisedValue = jlimit(0.0f, 1.0f, value);
+
+            // Same interpolator on the longer choice list:
+            if (version < 2 && parameters.getUnchecked(i) == mInterpolationParameter) {
+                normalisedValue = mInterpolationParameter->convertTo0to1((float) roundToInt(normalisedValue * (numVersion1Interpolations - 1)));
+            }
+
+            parameters.getUnchecked(i)->setValueNotifyingHost(normalisedValue);
+        }
     }
 
+    mCurrentProgram = isPositiveAndBelow(program, FROGGNumPresets) ? program : 0;
+    updateHostDisplay();
+}
+
+void FROGGAudioProcessor::setStateFromXml (const juce::XmlElement& xml)
+{
+    if (xml.hasTagName("FlangerChorus")) {
+        *mDryWetParameter = xml.getDoubleAttribute("DryWet");
+        *mDepthParameter = xml.getDoubleAttribute("Depth");
+        *mRateParameter = xml.getDoubleAttribute("Rate");
+        *mPhaseOffsetParameter = xml.getDoubleAttribute("PhaseOffset");
+        *mFeedbackParameter = xml.getDoubleAttribute("Feedback");
+        *mTypeParameter = xml.getIntAttribute("Type");
+        *mVoicesParameter = xml.getIntAttribute("Voices", 1);
+        *mInterpolationParameter = xml.getIntAttribute("Interpolation", 0);
+        *mOversamplingParameter = xml.getIntAttribute("Oversampling", 0);
+        *mLFOSyncParameter = xml.getIntAttribute("LFOSync", 0);
+        *mQualityParameter = xml.getIntAttribute("Quality", FROGGLegacyQualityTier);
+    }
 }
 
 //==============================================================================
@@ -395,8 +721,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new FROGGAudioProcessor();
 }
-
-float FROGGAudioProcessor::lin_interp(float sample_x, float sample_x1, float inPhase)
-{
-    return (1 - inPhase) * sample_x + inPhase * sample_x1;
-}
@@ -9,12 +9,18 @@
 #pragma once
 
 #include <JuceHeader.h>
-#define MAX_DELAY_TIME 2
+#include "DSP/FROGGCore.h"
+#include "FROGGLoadMeter.h"
+#include "FROGGParameterEvents.h"
+#include "FROGGPresets.h"
+#include "FROGGVisualiserFeed.h"
 
 //==============================================================================
 /**
 */
-class FROGGAudioProcessor  : public juce::AudioProcessor
+class FROGGAudioProcessor  : public juce::AudioProcessor,
+                             private juce::AsyncUpdater,
+                             private FROGGOversamplerFactory
 {
 public:
     //==============================================================================
@@ -30,6 +36,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // The delay runs in double precision end to end when the host asks for it:
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -51,13 +61,67 @@ public:
     void changeProgramName (int index, const juce::String& newName) override;
 
     //==============================================================================
+    // Compact binary state (see stateMagic), sessions saved as FlangerChorus XML still load:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
-    float lin_interp(float sample_x, float sample_x1, float inPhase);
+
+    // Timed parameter change from a caller that knows where in the block it lands (FROGGBench, an
+    // application hosting the processor itself): parameter parameterIndex takes the normalised value
+    // at sampleOffset samples into the next processBlock call, until the end of that block. The
+    // parameter, owned by the host, keeps its value. Host automation does not come through here:
+    // JUCE's plugin wrappers set the parameters before processBlock, without offsets, so it lands
+    // at block starts. Call from the audio thread, before that processBlock; false when too many
+    // events are pending:
+    bool queueParameterChange (int parameterIndex, float value, int sampleOffset);
+
+    // Input that has to be run through the processor before a chunk of an offline render starts,
+    // so its delay and feedback state match an uninterrupted render (within the silence threshold).
+    // Together with the Playhead or Tempo LFO sync, chunks of one long render can be processed
+    // separately and joined sample for sample: play the preroll with the playhead at its real
+    // position, discard that output, then keep the chunk's output.
+    double getPrerollSeconds() const;
+
+    // CPU load of processBlock, safe to read from the message thread:
+    FROGGLoadMeter& getLoadMeter() { return mLoadMeter; }
+
+    // LFO, delay time and level frames for the editor's visualiser:
+    FROGGVisualiserFeed& getVisualiserFeed() { return mVisualiserFeed; }
 
 private:
 
-    float mDelayTimeSmoothed;
+    //==============================================================================
+    // Oversamplers of the core, the JUCE half band filters (FROGGJUCEOversampler):
+    std::unique_ptr<FROGGOversampler<float>> createFloat (int factor, int numChannels, int maxBlockSize) override;
+    std::unique_ptr<FROGGOversampler<double>> createDouble (int factor, int numChannels, int maxBlockSize) override;
+
+    // Sets the sound parameters to a preset. From the audio thread without notifying
+    // the host (handleAsyncUpdate does that later), from the message thread with:
+    void setPresetValues (const FROGGPreset& preset, bool notifyHost);
+
+    // Audio thread side of setCurrentProgram: fades the wet signal out, swaps in the
+    // requested preset once it is silent, and lets the smoothers fade it back in:
+    void updateProgramChange();
+
+    // Prepares the core's double engine for a tier that asks for it, reports a latency the core
+    // moved to, and tells the host and the editor about parameters set by a program change:
+    void handleAsyncUpdate() override;
+
+    // Reads the XML state written before the binary format:
+    void setStateFromXml (const juce::XmlElement& xml);
+
+    // Copies the current parameter values, read once per block:
+    FROGGCore::Parameters getParameterSnapshot() const;
+
+    // Sets the value of parameter parameterIndex in snapshot from a normalised value, for a timed change:
+    void applyParameterEvent (FROGGCore::Parameters& snapshot, int parameterIndex, float value) const;
+
+    // processBlock for either precision:
+    template <typename SampleType>
+    void process (juce::AudioBuffer<SampleType>& buffer);
+
+    // Puts the core's LFO on the playhead's timeline for the Playhead and Tempo sync modes, when the host
+    // starts playing or the playhead jumps, and sets the tempo's rate in snapshot for Tempo:
+    void syncLFOToPlayhead (FROGGCore::Parameters& snapshot, int numSamples);
 
     // Flanger / Chorus Parameters:
 
@@ -79,18 +143,56 @@ private:
     // Parameter to control the  type of modulation effect: Chorus or Flanger:
     AudioParameterInt* mTypeParameter;
 
-    // Circular buffer for delay of each channel:
-    float* mCircularBufferLeft;
-    float* mCircularBufferRight;
+    // Parameter to control the number of ensemble voices reading the same delay line:
+    AudioParameterInt* mVoicesParameter;
+
+    // Parameter to choose the interpolator of the delayed signal: Linear, Hermite, Lagrange, Sinc or Auto (the quality tier's):
+    AudioParameterChoice* mInterpolationParameter;
+
+    // Parameter to run the delay at 2x or 4x the host rate: Off, 2x or 4x:
+    AudioParameterChoice* mOversamplingParameter;
+
+    // Parameter to derive the LFO phase from the host position: Free, Playhead or Tempo:
+    AudioParameterChoice* mLFOSyncParameter;
+
+    // Parameter to trade accuracy for CPU, one of FROGGQualityTiers: Eco, Standard, High or Ultra:
+    AudioParameterChoice* mQualityParameter;
+
+    // Parameter to run the wet path of 88.2 kHz and higher sessions at 44.1 / 48 kHz: Full Rate or Reduced:
+    AudioParameterChoice* mRateReductionParameter;
+
+    // Number of channels prepared, all processed by the same kernels:
+    int mNumChannels;
+
+    // Smoothing, LFO, delay, resampling and mix of every channel, in either precision:
+    FROGGCore mCore;
+
+    // Timed parameter changes waiting for their sample:
+    FROGGParameterEvents mParameterEvents;
+
+    // Sync mode the core's LFO follows the playhead in (0 until it is synced), and the playhead
+    // position the next block starts at unless it jumps:
+    int mLFOSyncMode;
+    juce::int64 mNextPlayheadPosition;
+
+    // Time each block takes against its real-time budget:
+    FROGGLoadMeter mLoadMeter;
+
+    // Program shown to the host, and the one requested by setCurrentProgram (-1 for none):
+    std::atomic<int> mCurrentProgram;
+    std::atomic<int> mPendingProgram;
+
+    // Program waiting for the wet fade out on the audio thread (-1 for none):
+    int mSwitchingProgram;
 
-    int mCircularBufferWriteHead;
-    int mCircularBufferLenght;
+    // Whether handleAsyncUpdate has program values to tell the host about:
+    std::atomic<bool> mProgramChanged;
 
-    // Feedback to send to input:
-    float mFeedbackLeft;
-    float mFeedbackRight;
+    // Whether processBlock is running, program changes are applied directly otherwise:
+    std::atomic<bool> mIsPrepared;
 
-    float mLFOPhase;
+    // Modulation and levels sent to the editor by the core, only while one is open:
+    FROGGVisualiserFeed mVisualiserFeed;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FROGGAudioProcessor)
@@ -0,0 +1,679 @@
+/*
+  ==============================================================================
+
+    Headless batch renderer: runs audio files through FROGGAudioProcessor
+    without a host, many files at a time. Also renders test signals over
+    parameter grids; Tools/FROGGTests checks the core against reference
+    renders.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <map>
+#include "../../../Source/PluginProcessor.h"
+
+//==============================================================================
+namespace
+{
+    // Everything the command line sets, shared by all the render jobs:
+    struct BatchSettings
+    {
+        juce::File outputDirectory;
+        juce::MemoryBlock state;
+        juce::StringPairArray parameters;
+        int blockSize = 65536;
+        bool randomBlockSizes = false;
+        double tailSeconds = 0.0;
+        double chunkSeconds = 0.0;
+        double bpm = 120.0;
+    };
+
+    juce::CriticalSection outputLock;
+
+    void printLine (const juce::String& line)
+    {
+        const juce::ScopedLock lock(outputLock);
+        std::cout << line << std::endl;
+    }
+
+    juce::String formatSpeed (double audioSeconds, double renderSeconds)
+    {
+        // Real-time factor is processing time over audio time, lower is faster:
+        const double rtf = audioSeconds > 0.0 ? renderSeconds / audioSeconds : 0.0;
+        const double speed = renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0;
+
+        return juce::String(audioSeconds, 2) + " s of audio in " + juce::String(renderSeconds, 3)
+            + " s, RTF " + juce::String(rtf, 5) + " (" + juce::String(speed, 1) + "x real time)";
+    }
+
+    //==============================================================================
+    /**
+        Writes one of the test signals as a 32 bit float WAV, the same samples on
+        every run: "impulse" (a unit impulse every half second), "sweep" (an
+        exponential sine sweep from 20 Hz to 20 kHz at -6 dBFS), "noise" (white
+        noise at -12 dBFS, different on every channel) or "burst" (silence for
+        the first half, then 200 ms of noise, waking the processor from idle).
+    */
+    bool writeTestSignal (const juce::File& file, const juce::String& signal, double sampleRate, int numChannels, double seconds)
+    {
+        const int length = juce::jmax(1, (int) (seconds * sampleRate));
+        juce::AudioBuffer<float> buffer(numChannels, length);
+        buffer.clear();
+
+        const double sweepStart = 20.0;
+        const double sweepEnd = juce::jmin(20000.0, sampleRate * 0.45);
+        const double sweepRatio = std::log(sweepEnd / sweepStart);
+        const int burstStart = length / 2;
+        const int burstEnd = juce::jmin(length, burstStart + (int) (0.2 * sampleRate));
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            float* samples = buffer.getWritePointer(channel);
+            juce::Random random(1234 + channel);
+
+            for (int i = 0; i < length; i++) {
+                if (signal == "impulse") {
+                    samples[i] = i % juce::jmax(1, (int) (0.5 * sampleRate)) == 0 ? 1.0f : 0.0f;
+                }
+                else if (signal == "sweep") {
+                    // Phase of a frequency rising exponentially over the whole length:
+                    const double t = (double) i / (double) length;
+                    const double phase = juce::MathConstants<double>::twoPi * sweepStart * seconds / sweepRatio * (std::exp(t * sweepRatio) - 1.0);
+                    samples[i] = (float) (0.5 * std::sin(phase));
+                }
+                else if (signal == "noise") {
+                    samples[i] = 0.25f * (2.0f * random.nextFloat() - 1.0f);
+                }
+                else if (signal == "burst") {
+                    samples[i] = i >= burstStart && i < burstEnd ? 0.5f * (2.0f * random.nextFloat() - 1.0f) : 0.0f;
+                }
+                else {
+                    return false;
+                }
+            }
+        }
+
+        file.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels, 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        // The writer owns the stream now:
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, length);
+    }
+
+    //==============================================================================
+    // Timeline of the render, the processor reads its LFO phase from it in the Playhead and Tempo modes:
+    class RenderPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        RenderPlayHead (double sampleRate, double bpm) : mSampleRate(sampleRate), mBpm(bpm) {}
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying(true);
+            info.setTimeInSamples(position);
+            info.setTimeInSeconds((double) position / mSampleRate);
+            info.setBpm(mBpm);
+            info.setPpqPosition((double) position / mSampleRate * mBpm / 60.0);
+            return info;
+        }
+
+        juce::int64 position = 0;
+
+    private:
+        double mSampleRate;
+        double mBpm;
+    };
+
+    //==============================================================================
+    /**
+        One output file, shared by the jobs rendering its chunks.
+
+        Chunks can finish in any order; each is kept until the ones before it
+        are written, so the file is written front to back. The writer is only
+        opened once there is something to write, so thousands of queued files
+        don't hold thousands of open files.
+    */
+    struct FileRender
+    {
+        juce::File inputFile;
+        juce::File outputFile;
+        juce::StringPairArray parameters;
+        juce::AudioFormat* format = nullptr;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        int bitsPerSample = 0;
+        juce::int64 outputLength = 0;
+        int numChunks = 1;
+
+        juce::CriticalSection lock;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        std::map<int, juce::AudioBuffer<float>> finishedChunks;
+        int nextChunk = 0;
+        int numDone = 0;
+        double startTime = 0.0;
+        juce::String error;
+
+        // Writes numSamples of buffer from startSample, in order; call with the lock held:
+        bool write (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+        {
+            if (writer == nullptr) {
+                outputFile.deleteFile();
+                std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+
+                if (stream != nullptr) {
+                    writer.reset(format->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels, bitsPerSample, {}, 0));
+                }
+
+                if (writer == nullptr) {
+                    error = "can't write " + outputFile.getFullPathName();
+                    return false;
+                }
+
+                // The writer owns the stream now:
+                stream.release();
+            }
+
+            if (! writer->writeFromAudioSampleBuffer(buffer, startSample, numSamples)) {
+                error = "write error";
+                return false;
+            }
+
+            return true;
+        }
+
+        // Hands over a rendered chunk and writes every chunk that is next in line:
+        void submit (int chunkIndex, juce::AudioBuffer<float>&& buffer)
+        {
+            const juce::ScopedLock scopedLock(lock);
+            finishedChunks[chunkIndex] = std::move(buffer);
+
+            for (auto next = finishedChunks.find(nextChunk); next != finishedChunks.end(); next = finishedChunks.find(nextChunk)) {
+                if (error.isEmpty()) {
+                    write(next->second, 0, next->second.getNumSamples());
+                }
+
+                finishedChunks.erase(next);
+                nextChunk++;
+            }
+        }
+    };
+
+    //==============================================================================
+    /**
+        Renders the output samples chunkStart..chunkEnd of one file: reads the
+        input in blocks of settings.blockSize, runs every block through its own
+        processor and writes the result. The processor latency (oversampling
+        filters) is compensated for, so the output lines up with the input.
+
+        A chunk that doesn't start at 0 first plays the processor's preroll, so
+        its delay and feedback state match an uninterrupted render, and uses a
+        playhead derived LFO phase, so the modulation matches too; the chunks
+        of a file join seamlessly.
+    */
+    class RenderJob : public juce::ThreadPoolJob
+    {
+    public:
+        RenderJob (FileRender& file, int chunkIndex, juce::int64 chunkStart, juce::int64 chunkEnd, const BatchSettings& settings,
+                   juce::AudioFormatManager& formatManager, std::atomic<int>& numFailures)
+            : juce::ThreadPoolJob(file.inputFile.getFileName()),
+              mFile(file),
+              mChunkIndex(chunkIndex),
+              mChunkStart(chunkStart),
+              mChunkEnd(chunkEnd),
+              mSettings(settings),
+              mFormatManager(formatManager),
+              mNumFailures(numFailures)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            {
+                const juce::ScopedLock lock(mFile.lock);
+
+                if (mFile.startTime == 0.0) {
+                    mFile.startTime = juce::Time::getMillisecondCounterHiRes();
+                }
+            }
+
+            const juce::String error = render();
+
+            const juce::ScopedLock lock(mFile.lock);
+
+            if (error.isNotEmpty() && mFile.error.isEmpty()) {
+                mFile.error = error;
+            }
+
+            // The last chunk to finish reports the file and closes it:
+            if (++mFile.numDone == mFile.numChunks) {
+                mFile.writer = nullptr;
+
+                if (mFile.error.isNotEmpty()) {
+                    printLine(mFile.outputFile.getFileName() + ": " + mFile.error);
+                    ++mNumFailures;
+                }
+                else {
+                    const double renderSeconds = (juce::Time::getMillisecondCounterHiRes() - mFile.startTime) * 0.001;
+                    printLine(mFile.outputFile.getFileName() + ": " + formatSpeed((double) mFile.outputLength / mFile.sampleRate, renderSeconds));
+                }
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        juce::String render()
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(mFormatManager.createReaderFor(mFile.inputFile));
+
+            if (reader == nullptr) {
+                return "can't read the file";
+            }
+
+            const int numChannels = mFile.numChannels;
+            const bool isChunked = mFile.numChunks > 1;
+
+            // Processor set up exactly like a host would, for this file's channel count and rate:
+            FROGGAudioProcessor processor;
+
+            if (mSettings.state.getSize() > 0) {
+                processor.setStateInformation(mSettings.state.getData(), (int) mSettings.state.getSize());
+            }
+
+            const juce::String parameterError = applyParameters(processor);
+
+            if (parameterError.isNotEmpty()) {
+                return parameterError;
+            }
+
+            // Chunks only join if the LFO phase comes from the position rather than the history:
+            if (isChunked) {
+                setParameterText(processor, "lfosync", "Playhead", true);
+            }
+
+            RenderPlayHead playHead(mFile.sampleRate, mSettings.bpm);
+            processor.setPlayHead(&playHead);
+
+            processor.setPlayConfigDetails(numChannels, numChannels, mFile.sampleRate, mSettings.blockSize);
+            processor.setNonRealtime(true);
+            processor.prepareToPlay(mFile.sampleRate, mSettings.blockSize);
+
+            // Input from the preroll before the chunk up to its end plus the latency, the output
+            // sample of input sample n is n - latency:
+            const juce::int64 latency = processor.getLatencySamples();
+            const juce::int64 preroll = mChunkStart > 0 ? (juce::int64) std::ceil(processor.getPrerollSeconds() * mFile.sampleRate) : 0;
+            const juce::int64 inputStart = juce::jmax((juce::int64) 0, mChunkStart - preroll);
+            const juce::int64 inputEnd = mChunkEnd + latency;
+
+            juce::AudioBuffer<float> buffer(numChannels, mSettings.blockSize);
+            juce::AudioBuffer<float> chunk(isChunked ? numChannels : 0, isChunked ? (int) (mChunkEnd - mChunkStart) : 0);
+            juce::MidiBuffer midi;
+
+            // Random host block sizes come in the same order on every run:
+            juce::Random blockSizes(1234 + mChunkIndex);
+
+            for (juce::int64 inputPosition = inputStart; inputPosition < inputEnd; ) {
+                const int nextBlockSize = mSettings.randomBlockSizes ? 1 + blockSizes.nextInt(mSettings.blockSize) : mSettings.blockSize;
+                const int blockSize = (int) juce::jmin((juce::int64) nextBlockSize, inputEnd - inputPosition);
+
+                // Past the end of the file the reader fills in silence, the tail and latency run out on it:
+                buffer.setSize(numChannels, blockSize, false, false, true);
+                reader->read(&buffer, 0, blockSize, inputPosition, true, true);
+
+                playHead.position = inputPosition;
+                processor.processBlock(buffer, midi);
+
+                // Keep the part of the block that lands inside the chunk:
+                const juce::int64 outputPosition = inputPosition - latency;
+                const juce::int64 keepStart = juce::jmax(outputPosition, mChunkStart);
+                const juce::int64 keepEnd = juce::jmin(outputPosition + blockSize, mChunkEnd);
+
+                if (keepEnd > keepStart) {
+                    const int offset = (int) (keepStart - outputPosition);
+                    const int numSamples = (int) (keepEnd - keepStart);
+
+                    if (isChunked) {
+                        for (int channel = 0; channel < numChannels; channel++) {
+                            chunk.copyFrom(channel, (int) (keepStart - mChunkStart), buffer, channel, offset, numSamples);
+                        }
+                    }
+                    else {
+                        const juce::ScopedLock lock(mFile.lock);
+
+                        if (! mFile.write(buffer, offset, numSamples)) {
+                            return mFile.error;
+                        }
+                    }
+                }
+
+                inputPosition += blockSize;
+            }
+
+            processor.releaseResources();
+            processor.setPlayHead(nullptr);
+
+            if (isChunked) {
+                mFile.submit(mChunkIndex, std::move(chunk));
+            }
+
+            return {};
+        }
+
+        // Sets the --param values of this file, given as the text the parameter displays (numbers, or choice names):
+        juce::String applyParameters (juce::AudioProcessor& processor) const
+        {
+            const juce::StringArray& ids = mFile.parameters.getAllKeys();
+
+            for (int i = 0; i < ids.size(); i++) {
+                if (! setParameterText(processor, ids[i], mFile.parameters[ids[i]], false)) {
+                    return "unknown parameter " + ids[i];
+                }
+            }
+
+            return {};
+        }
+
+        // Sets a parameter by ID, or with onlyIfDefault only when it is still at its default value:
+        static bool setParameterText (juce::AudioProcessor& processor, const juce::String& parameterID, const juce::String& text, bool onlyIfDefault)
+        {
+            for (auto* parameter : processor.getParameters()) {
+                if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter)) {
+                    if (withID->paramID == parameterID) {
+                        if (! onlyIfDefault || withID->getValue() == withID->getDefaultValue()) {
+                            withID->setValueNotifyingHost(withID->getValueForText(text));
+                        }
+
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        FileRender& mFile;
+        int mChunkIndex;
+        juce::int64 mChunkStart;
+        juce::int64 mChunkEnd;
+        const BatchSettings& mSettings;
+        juce::AudioFormatManager& mFormatManager;
+        std::atomic<int>& mNumFailures;
+
+        JUCE_DECLARE_NON_COPYABLE (RenderJob)
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: FROGGBatch [options] <input files...>" << std::endl
+                  << std::endl
+                  << "  --output <directory>     where the rendered files go (default: next to the inputs)" << std::endl
+                  << "  --state <file>           plugin state saved by a host (getStateInformation)" << std::endl
+                  << "  --param <id>=<value>     parameter value, e.g. --param rate=2.5 --param oversampling=4x;" << std::endl
+                  << "                           comma separated values render every combination, e.g." << std::endl
+                  << "                           --param voices=1,4 --param rate=0.5,20 renders four files" << std::endl
+                  << "  --threads <count>        jobs rendered in parallel (default: one per CPU core)" << std::endl
+                  << "  --block-size <samples>   samples per processBlock call (default: 65536)" << std::endl
+                  << "  --random-blocks          host block sizes drawn at random up to --block-size, the same" << std::endl
+                  << "                           sequence on every run" << std::endl
+                  << "  --tail <seconds>         extra output after the end of each file (default: 0)" << std::endl
+                  << "  --chunk <seconds>        split long files into chunks rendered in parallel, joined" << std::endl
+                  << "                           seamlessly (the LFO follows the playhead, lfosync=Playhead" << std::endl
+                  << "                           unless set otherwise)" << std::endl
+                  << "  --bpm <tempo>            tempo of the timeline for lfosync=Tempo (default: 120)" << std::endl
+                  << std::endl
+                  << "Test signals:" << std::endl
+                  << std::endl
+                  << "  --signal <name>          adds a generated input: impulse, sweep, noise or burst (silence," << std::endl
+                  << "                           then noise), written to the output directory as a float WAV" << std::endl
+                  << "  --sample-rate <rates>    comma separated rates of the test signals (default: 48000)" << std::endl
+                  << "  --channels <count>       channels of the test signals (default: 2)" << std::endl
+                  << "  --length <seconds>       length of the test signals (default: 2)" << std::endl
+                  << "  --isa <name>             kernels to render with: generic, sse2, avx2, avx512 or neon" << std::endl
+                  << "                           (default: best for the CPU)" << std::endl;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor and its parameters expect the JUCE runtime to be up:
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BatchSettings settings;
+    juce::Array<juce::File> inputFiles;
+    int numThreads = juce::SystemStats::getNumCpus();
+
+    juce::StringArray signals;
+    juce::StringArray signalRates { "48000" };
+    int signalChannels = 2;
+    double signalSeconds = 2.0;
+
+    for (int i = 1; i < argc; i++) {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--output" && hasValue) {
+            settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (argument == "--state" && hasValue) {
+            const juce::File stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+
+            if (! stateFile.loadFileAsData(settings.state)) {
+                std::cout << "Can't read the state file " << stateFile.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--param" && hasValue) {
+            const juce::String assignment(argv[++i]);
+            settings.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                    assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (argument == "--threads" && hasValue) {
+            numThreads = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (argument == "--block-size" && hasValue) {
+            settings.blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (argument == "--tail" && hasValue) {
+            settings.tailSeconds = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (argument == "--chunk" && hasValue) {
+            settings.chunkSeconds = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (argument == "--bpm" && hasValue) {
+            settings.bpm = juce::jmax(1.0, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (argument == "--random-blocks") {
+            settings.randomBlockSizes = true;
+        }
+        else if (argument == "--signal" && hasValue) {
+            signals.add(argv[++i]);
+        }
+        else if (argument == "--sample-rate" && hasValue) {
+            signalRates = juce::StringArray::fromTokens(argv[++i], ",", "");
+        }
+        else if (argument == "--channels" && hasValue) {
+            signalChannels = juce::jlimit(1, FROGGMaxChannels, juce::String(argv[++i]).getIntValue());
+        }
+        else if (argument == "--length" && hasValue) {
+            signalSeconds = juce::jmax(0.01, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (argument == "--isa" && hasValue) {
+            // Before any processor is prepared, the delay lines are laid out for the chosen kernels:
+            FROGGInstructionSet instructionSet;
+
+            if (! FROGGGetInstructionSet(argv[++i], instructionSet) || ! FROGGForceInstructionSet(instructionSet)) {
+                std::cout << "Instruction set " << argv[i] << " is not available on this build or CPU" << std::endl;
+                return 1;
+            }
+        }
+        else if (argument.startsWith("--")) {
+            printUsage();
+            return 1;
+        }
+        else {
+            inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(argument));
+        }
+    }
+
+    if (settings.outputDirectory != juce::File()) {
+        settings.outputDirectory.createDirectory();
+    }
+
+    // Test signals are written first and then rendered like any other input:
+    const juce::File signalDirectory = settings.outputDirectory == juce::File() ? juce::File::getCurrentWorkingDirectory()
+                                                                              : settings.outputDirectory;
+
+    for (const juce::String& signal : signals) {
+        for (const juce::String& rate : signalRates) {
+            const double sampleRate = rate.getDoubleValue();
+            const juce::File signalFile = signalDirectory.getChildFile(signal + "_" + juce::String(juce::roundToInt(sampleRate)) + ".wav");
+
+            if (sampleRate <= 0.0 || ! writeTestSignal(signalFile, signal, sampleRate, signalChannels, signalSeconds)) {
+                std::cout << "Can't write the " << signal << " signal at " << rate << " Hz" << std::endl;
+                return 1;
+            }
+
+            inputFiles.add(signalFile);
+        }
+    }
+
+    if (inputFiles.isEmpty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Every combination of the comma separated --param values, the ones with more than one
+    // value name the output files:
+    juce::Array<juce::StringPairArray> parameterSets { juce::StringPairArray() };
+    juce::StringArray gridParameters;
+
+    for (const juce::String& parameterID : settings.parameters.getAllKeys()) {
+        const juce::StringArray values = juce::StringArray::fromTokens(settings.parameters[parameterID], ",", "");
+
+        if (values.size() > 1) {
+            gridParameters.add(parameterID);
+        }
+
+        juce::Array<juce::StringPairArray> combinations;
+
+        for (const juce::StringPairArray& parameterSet : parameterSets) {
+            for (const juce::String& value : values) {
+                juce::StringPairArray combination(parameterSet);
+                combination.set(parameterID, value.trim());
+                combinations.add(combination);
+            }
+        }
+
+        parameterSets = combinations;
+    }
+
+    // WAV and AIFF, both read and written:
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    // Length, rate and chunks of every file, read up front so the chunks can be queued:
+    std::vector<std::unique_ptr<FileRender>> files;
+    std::atomic<int> numFailures { 0 };
+    int numJobs = 0;
+
+    for (const juce::File& inputFile : inputFiles) {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+
+        if (reader == nullptr) {
+            printLine(inputFile.getFileName() + ": can't read the file");
+            numFailures += parameterSets.size();
+            continue;
+        }
+
+        if (reader->numChannels < 1 || (int) reader->numChannels > FROGGMaxChannels) {
+            printLine(inputFile.getFileName() + ": unsupported number of channels (" + juce::String((int) reader->numChannels) + ")");
+            numFailures += parameterSets.size();
+            continue;
+        }
+
+        // Output next to the input unless a directory was given, same format:
+        const juce::File outputDirectory = settings.outputDirectory == juce::File() ? inputFile.getParentDirectory()
+                                                                                  : settings.outputDirectory;
+
+        for (const juce::StringPairArray& parameterSet : parameterSets) {
+            juce::String suffix = "_FROGG";
+
+            for (const juce::String& parameterID : gridParameters) {
+                suffix += "_" + parameterID + juce::File::createLegalFileName(parameterSet[parameterID]);
+            }
+
+            auto file = std::make_unique<FileRender>();
+            file->inputFile = inputFile;
+            file->outputFile = outputDirectory.getChildFile(inputFile.getFileNameWithoutExtension() + suffix + inputFile.getFileExtension());
+            file->parameters = parameterSet;
+            file->format = formatManager.findFormatForFileExtension(inputFile.getFileExtension());
+            file->sampleRate = reader->sampleRate;
+            file->numChannels = (int) reader->numChannels;
+            file->bitsPerSample = (int) reader->bitsPerSample;
+            file->outputLength = reader->lengthInSamples + (juce::int64) (settings.tailSeconds * reader->sampleRate);
+
+            const juce::int64 chunkLength = settings.chunkSeconds > 0.0 ? juce::jmax((juce::int64) 1, (juce::int64) (settings.chunkSeconds * reader->sampleRate))
+                                                                        : juce::jmax((juce::int64) 1, file->outputLength);
+            file->numChunks = (int) juce::jmax((juce::int64) 1, (file->outputLength + chunkLength - 1) / chunkLength);
+
+            if (file->format == nullptr) {
+                printLine(inputFile.getFileName() + ": can't write " + file->outputFile.getFullPathName());
+                ++numFailures;
+                continue;
+            }
+
+            numJobs += file->numChunks;
+            files.push_back(std::move(file));
+        }
+    }
+
+    // One job per chunk, the pool runs numThreads of them at a time:
+    const double startTime = juce::Time::getMillisecondCounterHiRes();
+
+    if (numJobs > 0) {
+        juce::ThreadPool pool(juce::jmin(numThreads, numJobs));
+
+        for (auto& file : files) {
+            const juce::int64 chunkLength = (file->outputLength + file->numChunks - 1) / file->numChunks;
+
+            for (int chunk = 0; chunk < file->numChunks; chunk++) {
+                const juce::int64 chunkStart = chunk * chunkLength;
+                const juce::int64 chunkEnd = juce::jmin(file->outputLength, chunkStart + chunkLength);
+                pool.addJob(new RenderJob(*file, chunk, chunkStart, chunkEnd, settings, formatManager, numFailures), true);
+            }
+        }
+
+        while (pool.getNumJobs() > 0) {
+            juce::Thread::sleep(20);
+        }
+    }
+
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    double audioSeconds = 0.0;
+
+    for (auto& file : files) {
+        audioSeconds += (double) file->outputLength / file->sampleRate;
+    }
+
+    // One output file per input and parameter combination:
+    const int numRenders = inputFiles.size() * parameterSets.size();
+
+    printLine("Total: " + juce::String(numRenders - numFailures.load()) + " of " + juce::String(numRenders)
+              + " files, " + formatSpeed(audioSeconds, wallSeconds));
+
+    return numFailures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,395 @@
+/*
+  ==============================================================================
+
+    Microbenchmark for FROGGAudioProcessor::processBlock, sweeps sample rates,
+    block sizes, types, feedback and automation and reports the cost per sample.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../../Source/PluginProcessor.h"
+
+//==============================================================================
+namespace
+{
+    // How the parameters move during a case:
+    enum class Automation
+    {
+        none,           // Fixed values
+        perBlock,       // Set before every block, as most hosts automate
+        timed           // Queued at several offsets inside every block, splitting it
+    };
+
+    // Timed changes queued per block:
+    constexpr int numEventsPerBlock = 4;
+
+    // One point of the sweep:
+    struct BenchCase
+    {
+        double sampleRate;
+        int blockSize;
+        int type;           // 0 = Chorus, 1 = Flanger
+        bool feedback;
+        Automation automation;
+    };
+
+    // What one case measured, block times in microseconds:
+    struct BenchResult
+    {
+        BenchCase benchCase;
+        double nsPerSample = 0.0;
+        double realTimeFactor = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double p999 = 0.0;
+        double max = 0.0;
+        double budget = 0.0;
+    };
+
+    // Options from the command line:
+    struct BenchSettings
+    {
+        double secondsPerCase = 2.0;
+        int numChannels = 2;
+        juce::StringPairArray parameters;
+        juce::File csvFile;
+        juce::File jsonFile;
+        bool quick = false;
+    };
+
+    // Sets a parameter by ID to a normalised value, as a host would:
+    void setParameter (juce::AudioProcessor& processor, const juce::String& parameterID, float normalisedValue)
+    {
+        for (auto* parameter : processor.getParameters()) {
+            if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter)) {
+                if (withID->paramID == parameterID) {
+                    withID->setValueNotifyingHost(normalisedValue);
+                }
+            }
+        }
+    }
+
+    // Index of a parameter in getParameters(), -1 for an unknown ID:
+    int getParameterIndex (juce::AudioProcessor& processor, const juce::String& parameterID)
+    {
+        auto& parameters = processor.getParameters();
+
+        for (int i = 0; i < parameters.size(); i++) {
+            if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameters.getUnchecked(i))) {
+                if (withID->paramID == parameterID) {
+                    return i;
+                }
+            }
+        }
+
+        return -1;
+    }
+
+    // Sets a parameter by ID to the value given as the text it displays:
+    bool setParameterText (juce::AudioProcessor& processor, const juce::String& parameterID, const juce::String& text)
+    {
+        for (auto* parameter : processor.getParameters()) {
+            if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter)) {
+                if (withID->paramID == parameterID) {
+                    withID->setValueNotifyingHost(withID->getValueForText(text));
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // Value below which the given fraction of the sorted times lies:
+    double percentile (const std::vector<double>& sortedTimes, double fraction)
+    {
+        const size_t index = (size_t) juce::jlimit(0.0, (double) sortedTimes.size() - 1.0,
+                                                   std::ceil(fraction * (double) sortedTimes.size()) - 1.0);
+        return sortedTimes[index];
+    }
+
+    //==============================================================================
+    /**
+        Runs one case: a fresh processor, prepared like a host would, fed noise
+        one block at a time for settings.secondsPerCase of audio after a short
+        warm up. Only processBlock is timed; in automated cases rate, depth and
+        dry / wet are moved every block, before the call, the way host
+        automation arrives: set once per block, or queued as timed changes at
+        numEventsPerBlock offsets (queueParameterChange), which split the block.
+    */
+    BenchResult runCase (const BenchCase& benchCase, const BenchSettings& settings)
+    {
+        FROGGAudioProcessor processor;
+
+        for (const juce::String& parameterID : settings.parameters.getAllKeys()) {
+            setParameterText(processor, parameterID, settings.parameters[parameterID]);
+        }
+
+        setParameter(processor, "type", (float) benchCase.type);
+        setParameter(processor, "feedback", benchCase.feedback ? 0.5f : 0.0f);
+
+        processor.setPlayConfigDetails(settings.numChannels, settings.numChannels, benchCase.sampleRate, benchCase.blockSize);
+        processor.prepareToPlay(benchCase.sampleRate, benchCase.blockSize);
+
+        // Noise input, copied into the processed buffer before every block:
+        juce::AudioBuffer<float> input(settings.numChannels, benchCase.blockSize);
+        juce::AudioBuffer<float> buffer(settings.numChannels, benchCase.blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+
+        for (int channel = 0; channel < settings.numChannels; channel++) {
+            for (int i = 0; i < benchCase.blockSize; i++) {
+                input.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+
+        const int sweptIndices[] = { getParameterIndex(processor, "rate"), getParameterIndex(processor, "depth"),
+                                     getParameterIndex(processor, "drywet") };
+
+        const int numWarmUpBlocks = juce::jmax(8, (int) (0.1 * benchCase.sampleRate) / benchCase.blockSize);
+        const int numBlocks = juce::jmax(16, (int) (settings.secondsPerCase * benchCase.sampleRate) / benchCase.blockSize);
+
+        std::vector<double> blockTimes;
+        blockTimes.reserve((size_t) numBlocks);
+
+        for (int block = 0; block < numWarmUpBlocks + numBlocks; block++) {
+            for (int channel = 0; channel < settings.numChannels; channel++) {
+                buffer.copyFrom(channel, 0, input, channel, 0, benchCase.blockSize);
+            }
+
+            // Slow sweeps, a full cycle about every second of audio:
+            auto getSweep = [&] (int sampleOffset)
+            {
+                return 0.5f + 0.5f * std::sin((float) (block * benchCase.blockSize + sampleOffset)
+                                              * juce::MathConstants<float>::twoPi / (float) benchCase.sampleRate);
+            };
+
+            if (benchCase.automation == Automation::perBlock) {
+                const float sweep = getSweep(0);
+                setParameter(processor, "rate", sweep);
+                setParameter(processor, "depth", 1.0f - sweep);
+                setParameter(processor, "drywet", 0.25f + 0.5f * sweep);
+            }
+            else if (benchCase.automation == Automation::timed) {
+                for (int event = 0; event < numEventsPerBlock; event++) {
+                    const int sampleOffset = event * benchCase.blockSize / numEventsPerBlock;
+                    const float sweep = getSweep(sampleOffset);
+                    processor.queueParameterChange(sweptIndices[0], sweep, sampleOffset);
+                    processor.queueParameterChange(sweptIndices[1], 1.0f - sweep, sampleOffset);
+                    processor.queueParameterChange(sweptIndices[2], 0.25f + 0.5f * sweep, sampleOffset);
+                }
+            }
+
+            const juce::int64 start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const juce::int64 end = juce::Time::getHighResolutionTicks();
+
+            if (block >= numWarmUpBlocks) {
+                blockTimes.push_back(juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+            }
+        }
+
+        processor.releaseResources();
+
+        double totalMicroseconds = 0.0;
+
+        for (double time : blockTimes) {
+            totalMicroseconds += time;
+        }
+
+        std::sort(blockTimes.begin(), blockTimes.end());
+
+        const double numSamples = (double) numBlocks * (double) benchCase.blockSize;
+
+        BenchResult result;
+        result.benchCase = benchCase;
+        result.nsPerSample = totalMicroseconds * 1000.0 / numSamples;
+        result.realTimeFactor = totalMicroseconds * 1.0e-6 / (numSamples / benchCase.sampleRate);
+        result.p50 = percentile(blockTimes, 0.5);
+        result.p99 = percentile(blockTimes, 0.99);
+        result.p999 = percentile(blockTimes, 0.999);
+        result.max = blockTimes.back();
+        result.budget = (double) benchCase.blockSize / benchCase.sampleRate * 1.0e6;
+        return result;
+    }
+
+    //==============================================================================
+    const char* getAutomationName (Automation automation)
+    {
+        return automation == Automation::perBlock ? "block" : automation == Automation::timed ? "timed" : "static";
+    }
+
+    juce::String describe (const BenchCase& benchCase)
+    {
+        return juce::String(benchCase.sampleRate / 1000.0, 1) + " kHz, " + juce::String(benchCase.blockSize).paddedLeft(' ', 4)
+            + " samples, " + (benchCase.type == 0 ? "chorus " : "flanger") + ", feedback " + (benchCase.feedback ? "on " : "off")
+            + ", " + juce::String(getAutomationName(benchCase.automation)).paddedRight(' ', 9);
+    }
+
+    void writeCSV (const juce::Array<BenchResult>& results, const juce::File& file)
+    {
+        juce::String csv = "sample_rate,block_size,type,feedback,automation,ns_per_sample,rtf,p50_us,p99_us,p999_us,max_us,budget_us\n";
+
+        for (const BenchResult& result : results) {
+            const BenchCase& c = result.benchCase;
+            csv << c.sampleRate << "," << c.blockSize << "," << (c.type == 0 ? "chorus" : "flanger") << ","
+                << (c.feedback ? 1 : 0) << "," << getAutomationName(c.automation) << "," << result.nsPerSample << ","
+                << result.realTimeFactor << "," << result.p50 << "," << result.p99 << "," << result.p999 << ","
+                << result.max << "," << result.budget << "\n";
+        }
+
+        file.replaceWithText(csv);
+    }
+
+    void writeJSON (const juce::Array<BenchResult>& results, const juce::File& file, const BenchSettings& settings)
+    {
+        juce::Array<juce::var> cases;
+
+        for (const BenchResult& result : results) {
+            const BenchCase& c = result.benchCase;
+            auto* object = new juce::DynamicObject();
+            object->setProperty("sampleRate", c.sampleRate);
+            object->setProperty("blockSize", c.blockSize);
+            object->setProperty("type", c.type == 0 ? "chorus" : "flanger");
+            object->setProperty("feedback", c.feedback);
+            object->setProperty("automation", getAutomationName(c.automation));
+            object->setProperty("nsPerSample", result.nsPerSample);
+            object->setProperty("realTimeFactor", result.realTimeFactor);
+            object->setProperty("p50Microseconds", result.p50);
+            object->setProperty("p99Microseconds", result.p99);
+            object->setProperty("p999Microseconds", result.p999);
+            object->setProperty("maxMicroseconds", result.max);
+            object->setProperty("budgetMicroseconds", result.budget);
+            cases.add(juce::var(object));
+        }
+
+        // Enough about the build and machine to tell runs apart:
+        auto* root = new juce::DynamicObject();
+        root->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("channels", settings.numChannels);
+        root->setProperty("secondsPerCase", settings.secondsPerCase);
+        root->setProperty("kernels", juce::String(FROGGGetKernels().name));
+        root->setProperty("results", cases);
+
+        file.replaceWithText(juce::JSON::toString(juce::var(root)));
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: FROGGBench [options]" << std::endl
+                  << std::endl
+                  << "  --seconds <seconds>      audio processed per case (default: 2)" << std::endl
+                  << "  --channels <count>       channels processed (default: 2)" << std::endl
+                  << "  --param <id>=<value>     fixed parameter value for every case, e.g. --param voices=4" << std::endl
+                  << "  --csv <file>             write the results as CSV" << std::endl
+                  << "  --json <file>            write the results as JSON" << std::endl
+                  << "  --quick                  48 kHz, 64 and 512 samples only" << std::endl
+                  << "  --isa <name>             kernels to run: generic, sse2, avx2, avx512 or neon (default: best for the CPU)" << std::endl;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor and its parameters expect the JUCE runtime to be up:
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--seconds" && hasValue) {
+            settings.secondsPerCase = juce::jmax(0.01, juce::String(argv[++i]).getDoubleValue());
+        }
+        else if (argument == "--channels" && hasValue) {
+            settings.numChannels = juce::jlimit(1, FROGGMaxChannels, juce::String(argv[++i]).getIntValue());
+        }
+        else if (argument == "--param" && hasValue) {
+            const juce::String assignment(argv[++i]);
+            settings.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                    assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (argument == "--csv" && hasValue) {
+            settings.csvFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (argument == "--json" && hasValue) {
+            settings.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        }
+        else if (argument == "--quick") {
+            settings.quick = true;
+        }
+        else if (argument == "--isa" && hasValue) {
+            // Before any processor is prepared, the delay lines are laid out for the chosen kernels:
+            FROGGInstructionSet instructionSet;
+
+            if (! FROGGGetInstructionSet(argv[++i], instructionSet) || ! FROGGForceInstructionSet(instructionSet)) {
+                std::cout << "Instruction set " << argv[i] << " is not available on this build or CPU" << std::endl;
+                return 1;
+            }
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Unknown IDs are caught once here rather than silently ignored in every case:
+    {
+        FROGGAudioProcessor processor;
+
+        for (const juce::String& parameterID : settings.parameters.getAllKeys()) {
+            if (! setParameterText(processor, parameterID, settings.parameters[parameterID])) {
+                std::cout << "Unknown parameter " << parameterID << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    const juce::Array<double> sampleRates = settings.quick ? juce::Array<double> { 48000.0 }
+                                                           : juce::Array<double> { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const juce::Array<int> blockSizes = settings.quick ? juce::Array<int> { 64, 512 }
+                                                       : juce::Array<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+    juce::Array<BenchResult> results;
+
+    std::cout << "Kernels: " << FROGGGetKernels().name << std::endl;
+    std::cout << "case                                                             ns/sample      RTF   p50 us   p99 us p99.9 us   max us" << std::endl;
+
+    for (double sampleRate : sampleRates) {
+        for (int blockSize : blockSizes) {
+            for (int type = 0; type < 2; type++) {
+                for (bool feedback : { false, true }) {
+                    for (Automation automation : { Automation::none, Automation::perBlock, Automation::timed }) {
+                        const BenchResult result = runCase({ sampleRate, blockSize, type, feedback, automation }, settings);
+                        results.add(result);
+
+                        std::cout << describe(result.benchCase)
+                                  << juce::String(result.nsPerSample, 2).paddedLeft(' ', 12)
+                                  << juce::String(result.realTimeFactor, 5).paddedLeft(' ', 9)
+                                  << juce::String(result.p50, 1).paddedLeft(' ', 9)
+                                  << juce::String(result.p99, 1).paddedLeft(' ', 9)
+                                  << juce::String(result.p999, 1).paddedLeft(' ', 9)
+                                  << juce::String(result.max, 1).paddedLeft(' ', 9) << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    if (settings.csvFile != juce::File()) {
+        writeCSV(results, settings.csvFile);
+    }
+
+    if (settings.jsonFile != juce::File()) {
+        writeJSON(results, settings.jsonFile, settings);
+    }
+
+    return 0;
+}
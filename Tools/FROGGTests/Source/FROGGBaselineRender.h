@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    The processing of the plugin before FROGGCore, kept as the reference the
+    tests hold the core to.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+    processBlock and prepareToPlay of FROGGAudioProcessor at commit 50957f9,
+    statement for statement, without JUCE: a stereo, linearly interpolated
+    delay line read by a sine LFO evaluated every sample, parameters constant
+    over the render and not smoothed.
+
+    The expressions keep the float / double mix of the original (the phase
+    increment and the sine in double, everything stored in float), since that
+    is what the reference renders sound like. Do not tidy them up: the files
+    in References are rendered by it (FROGGTests --write-references).
+*/
+class FROGGBaselineRender
+{
+public:
+    //==============================================================================
+    // Values of the parameters in their units, as the AudioParameterFloat / Int returned them:
+    struct Parameters
+    {
+        float dryWet;
+        float depth;
+        float rate;
+        float phaseOffset;
+        float feedback;
+        int type;       // 0 Chorus, 1 Flanger
+    };
+
+    //==============================================================================
+    // prepareToPlay: a two second circular buffer per channel, silent, the LFO at phase 0:
+    explicit FROGGBaselineRender (double sampleRate)
+        : mSampleRate(sampleRate)
+    {
+        mCircularBufferLenght = (int) (sampleRate * maxDelayTime);
+        mCircularBufferLeft.assign((size_t) mCircularBufferLenght, 0.0f);
+        mCircularBufferRight.assign((size_t) mCircularBufferLenght, 0.0f);
+    }
+
+    // processBlock on the two channels, in place:
+    void process (float* leftChannel, float* rightChannel, int numSamples, const Parameters& parameters)
+    {
+        const double pi = 3.14159265358979323846;
+
+        for (int i = 0; i < numSamples; i++) {
+
+            // Circular buffer write operation with feedback:
+            mCircularBufferLeft[(size_t) mCircularBufferWriteHead] = leftChannel[i] + mFeedbackLeft;
+            mCircularBufferRight[(size_t) mCircularBufferWriteHead] = rightChannel[i] + mFeedbackRight;
+
+            // LFO phase calculation and normalization:
+            float lfoOutLeft = (float) std::sin(2 * pi * mLFOPhase);
+            float lfoPhaseRight = mLFOPhase + parameters.phaseOffset;
+
+            if (lfoPhaseRight > 1) {
+                lfoPhaseRight -= 1;
+            }
+
+            float lfoOutRight = (float) std::sin(2 * pi * lfoPhaseRight);
+
+            // Update LFO phase:
+            mLFOPhase = (float) (mLFOPhase + parameters.rate / mSampleRate);
+
+            if (mLFOPhase > 1) {
+                mLFOPhase -= 1;
+            }
+
+            // Apply depth parameter to LFO output:
+            lfoOutLeft *= parameters.depth;
+            lfoOutRight *= parameters.depth;
+
+            // Map LFO output to the range of the type, as juce::jmap does:
+            float lfoOutMappedLeft = 0;
+            float lfoOutMappedRight = 0;
+
+            if (parameters.type == 0) {
+                lfoOutMappedLeft = jmap(lfoOutLeft, 0.005f, 0.03f);
+                lfoOutMappedRight = jmap(lfoOutRight, 0.005f, 0.03f);
+            }
+            else {
+                lfoOutMappedLeft = jmap(lfoOutLeft, 0.001f, 0.005f);
+                lfoOutMappedRight = jmap(lfoOutRight, 0.001f, 0.005f);
+            }
+
+            // Delay time in samples based on LFO output:
+            float delayTimeSamplesLeft = (float) (mSampleRate * lfoOutMappedLeft);
+            float delayTimeSamplesRight = (float) (mSampleRate * lfoOutMappedRight);
+
+            // Read heads for left and right channels, never less than 0:
+            float delayReadHeadLeft = mCircularBufferWriteHead - delayTimeSamplesLeft;
+            float delayReadHeadRight = mCircularBufferWriteHead - delayTimeSamplesRight;
+
+            if (delayReadHeadLeft < 0) {
+                delayReadHeadLeft += mCircularBufferLenght;
+            }
+
+            if (delayReadHeadRight < 0) {
+                delayReadHeadRight += mCircularBufferLenght;
+            }
+
+            // Integer and fractional parts of the read heads:
+            int readHeadLeft_x = (int) delayReadHeadLeft;
+            int readHeadLeft_x1 = readHeadLeft_x + 1;
+            float readHeadFloatLeft = delayReadHeadLeft - readHeadLeft_x;
+
+            int readHeadRight_x = (int) delayReadHeadRight;
+            int readHeadRight_x1 = readHeadRight_x + 1;
+            float readHeadFloatRight = delayReadHeadRight - readHeadRight_x;
+
+            if (readHeadLeft_x1 >= mCircularBufferLenght) {
+                readHeadLeft_x1 -= mCircularBufferLenght;
+            }
+
+            if (readHeadRight_x1 >= mCircularBufferLenght) {
+                readHeadRight_x1 -= mCircularBufferLenght;
+            }
+
+            // Linear interpolation of the delayed samples:
+            float delay_sample_left = lin_interp(mCircularBufferLeft[(size_t) readHeadLeft_x], mCircularBufferLeft[(size_t) readHeadLeft_x1], readHeadFloatLeft);
+            float delay_sample_right = lin_interp(mCircularBufferRight[(size_t) readHeadRight_x], mCircularBufferRight[(size_t) readHeadRight_x1], readHeadFloatRight);
+
+            // Feedback of the delayed samples:
+            mFeedbackLeft = delay_sample_left * parameters.feedback;
+            mFeedbackRight = delay_sample_right * parameters.feedback;
+
+            // Write head with wrap-around:
+            mCircularBufferWriteHead++;
+
+            if (mCircularBufferWriteHead >= mCircularBufferLenght) {
+                mCircularBufferWriteHead = 0;
+            }
+
+            // Dry and wet amounts:
+            float dryAmount = 1 - parameters.dryWet;
+            float wetAmount = parameters.dryWet;
+
+            leftChannel[i] = leftChannel[i] * dryAmount + delay_sample_left * wetAmount;
+            rightChannel[i] = rightChannel[i] * dryAmount + delay_sample_right * wetAmount;
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int maxDelayTime = 2;
+
+    // juce::jmap (value, -1, 1, targetMin, targetMax) in float:
+    static float jmap (float value, float targetMin, float targetMax)
+    {
+        return targetMin + ((targetMax - targetMin) * (value - -1.0f)) / (1.0f - -1.0f);
+    }
+
+    static float lin_interp (float sample_x, float sample_x1, float inPhase)
+    {
+        return (1 - inPhase) * sample_x + inPhase * sample_x1;
+    }
+
+    double mSampleRate;
+
+    std::vector<float> mCircularBufferLeft;
+    std::vector<float> mCircularBufferRight;
+
+    int mCircularBufferWriteHead = 0;
+    int mCircularBufferLenght = 0;
+
+    float mFeedbackLeft = 0;
+    float mFeedbackRight = 0;
+
+    float mLFOPhase = 0;
+};
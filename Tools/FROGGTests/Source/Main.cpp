@@ -0,0 +1,737 @@
+/*
+  ==============================================================================
+
+    Regression tests of the DSP core: renders test signals through FROGGCore
+    over a grid of parameters, block sizes, sample rates, quality settings and
+    instruction sets, and checks every render against the reference renders
+    of the plugin before the core, or against another render, case by case.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../../Source/DSP/FROGGCore.h"
+#include "../../../Source/DSP/FROGGKernels.h"
+#include "FROGGBaselineRender.h"
+
+//==============================================================================
+namespace
+{
+    // Length of every render, and the rates and block size of the references:
+    constexpr double renderSeconds = 0.15;
+    constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+    constexpr int referenceBlockSize = 512;
+    constexpr int numChannels = 2;
+
+    const char* const signalNames[] = { "impulse", "sweep", "noise", "burst" };
+
+    // Parameter sets of the grid, in the units of FROGGBaselineRender::Parameters:
+    struct ParameterSet
+    {
+        const char* name;
+        FROGGBaselineRender::Parameters values;
+    };
+
+    constexpr ParameterSet parameterSets[] =
+    {
+        { "default",    { 0.5f, 0.5f, 10.0f, 0.5f,  0.5f,  1 } },
+        { "chorus",     { 0.5f, 0.7f, 4.0f,  0.25f, 0.2f,  0 } },
+        { "feedback",   { 0.7f, 0.9f, 6.0f,  0.0f,  0.95f, 1 } },
+    };
+
+    //==============================================================================
+    /**
+        Largest difference each case accepts, in dBFS; bitExact for none. The
+        figures in the comments are the largest differences measured over the
+        whole grid (x86-64, AVX-512 machine), the tolerances leave a few dB above
+        them so a different compiler or CPU passes, a changed sound does not.
+    */
+    constexpr double bitExact = -std::numeric_limits<double>::infinity();
+
+    // High tier with Linear interpolation, the legacy settings, against the references; float and double
+    // buffers, and Ultra on Linear interpolation, which runs the double engine for them. The reference's
+    // read head is a float index into a two second buffer, so its fraction is only as fine as a float
+    // step there: 1/64 of a sample where it wraps, at the start of a render. That, not the core, makes
+    // most of the difference, which the feedback set carries on (measured -48.1 dBFS on the impulses,
+    // -60.0 dBFS on the other signals):
+    constexpr double legacyToleranceDb = -45.0;
+
+    // Kernels with FMA (AVX2, AVX-512) against the generic ones, which SSE2 matches bit for bit. The
+    // rounding differences go round the feedback and move with the read heads (measured -84.3 dBFS):
+    constexpr double fusedMultiplyAddToleranceDb = -78.0;
+
+    // Chunks of a render with the LFO on the timeline, each after a preroll of a tail, joined against
+    // the whole render: what the preroll leaves out has died away below FROGGCore::silenceThreshold
+    // (measured -144.5 dBFS, most renders bit exact):
+    const double chunkToleranceDb = 20.0 * std::log10((double) FROGGCore::silenceThreshold);
+
+    // Length of the chunked renders and how many chunks they are cut into, long enough that the last
+    // chunk of every parameter set starts after its preroll:
+    constexpr double chunkedRenderSeconds = 2.0;
+    constexpr int numChunks = 3;
+
+    /**
+        Settings that change the sound on purpose, measured against the references
+        and printed, and held to the block size cases instead. The largest
+        differences over the grid were:
+
+        - Eco and Standard on Linear interpolation, -6.8 and -7.8 dBFS: the LFO
+          steps its phase from one control point to the next, so it does not
+          pick up the rounding of the reference's float phase, which adds a
+          sample at a time and drifts by up to 1.4e-4 cycles over a render
+          (feedback set at 96 kHz, the top of the sweep).
+        - Eco, Standard, High and Ultra on Auto, -6.8, -2.0, -0.1 and +1.9 dBFS:
+          an impulse through Hermite, Lagrange or sinc instead of Linear.
+        - Rate reduction at 96 kHz, +7.7 dBFS: Linear interpolation at 48 kHz
+          dulls the top octave, and the feedback set rings on it.
+    */
+    struct Variant
+    {
+        const char* name;
+        int quality;
+        int interpolation;
+    };
+
+    constexpr Variant tradeOffs[] =
+    {
+        { "Eco",            0, (int) FROGGInterpolation::linear },
+        { "Standard",       1, (int) FROGGInterpolation::linear },
+        { "Eco Auto",       0, FROGGParameterStage::autoInterpolation },
+        { "Standard Auto",  1, FROGGParameterStage::autoInterpolation },
+        { "High Auto",      2, FROGGParameterStage::autoInterpolation },
+        { "Ultra Auto",     3, FROGGParameterStage::autoInterpolation },
+    };
+
+    //==============================================================================
+    // Planar audio, numChannels rows of length samples:
+    struct Audio
+    {
+        int length = 0;
+        std::vector<float> samples;
+
+        float* getChannel (int channel)             { return samples.data() + (size_t) channel * (size_t) length; }
+        const float* getChannel (int channel) const { return samples.data() + (size_t) channel * (size_t) length; }
+    };
+
+    // Numerical Recipes LCG, the same numbers on every platform:
+    struct Random
+    {
+        uint32_t state;
+
+        // Uniform in [0, 1):
+        float nextFloat()
+        {
+            state = state * 1664525u + 1013904223u;
+            return (float) (state >> 8) / 16777216.0f;
+        }
+
+        int nextInt (int maximum)
+        {
+            return std::min(maximum - 1, (int) (nextFloat() * (float) maximum));
+        }
+    };
+
+    //==============================================================================
+    /**
+        One of the test signals, the same samples on every run: "impulse" (a unit
+        impulse every 50 ms), "sweep" (an exponential sine sweep from 20 Hz to
+        20 kHz at -6 dBFS), "noise" (white noise at -12 dBFS, different on every
+        channel) or "burst" (silence for the first two thirds, then noise at -6 dBFS).
+        The references are seconds long.
+    */
+    Audio makeTestSignal (const std::string& signal, double sampleRate, double seconds = renderSeconds)
+    {
+        Audio audio;
+        audio.length = (int) (seconds * sampleRate);
+        audio.samples.assign((size_t) (numChannels * audio.length), 0.0f);
+
+        const double twoPi = 6.283185307179586476925;
+        const double sweepStart = 20.0;
+        const double sweepEnd = std::min(20000.0, sampleRate * 0.45);
+        const double sweepRatio = std::log(sweepEnd / sweepStart);
+        const int impulseInterval = (int) (0.05 * sampleRate);
+        const int burstStart = audio.length * 2 / 3;
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            float* samples = audio.getChannel(channel);
+            Random random { 1234u + (uint32_t) channel };
+
+            for (int i = 0; i < audio.length; i++) {
+                if (signal == "impulse") {
+                    samples[i] = i % impulseInterval == 0 ? 1.0f : 0.0f;
+                }
+                else if (signal == "sweep") {
+                    // Phase of a frequency rising exponentially over the whole length:
+                    const double t = (double) i / (double) audio.length;
+                    const double phase = twoPi * sweepStart * seconds / sweepRatio * (std::exp(t * sweepRatio) - 1.0);
+                    samples[i] = (float) (0.5 * std::sin(phase));
+                }
+                else if (signal == "noise") {
+                    samples[i] = 0.25f * (2.0f * random.nextFloat() - 1.0f);
+                }
+                else {
+                    samples[i] = i >= burstStart ? 0.5f * (2.0f * random.nextFloat() - 1.0f) : 0.0f;
+                }
+            }
+        }
+
+        return audio;
+    }
+
+    //==============================================================================
+    // 32 bit float WAV files, the format of the references. Little endian, as every supported platform:
+    bool writeWavFile (const std::string& path, const Audio& audio, double sampleRate)
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        if (! file)
+            return false;
+
+        const uint32_t dataSize = (uint32_t) (audio.samples.size() * sizeof (float));
+        const uint32_t rate = (uint32_t) sampleRate;
+        const uint16_t channels = (uint16_t) numChannels;
+
+        auto write32 = [&file] (uint32_t value) { file.write(reinterpret_cast<const char*>(&value), 4); };
+        auto write16 = [&file] (uint16_t value) { file.write(reinterpret_cast<const char*>(&value), 2); };
+
+        // RIFF header and a format chunk of IEEE float (format 3):
+        file.write("RIFF", 4);
+        write32(4 + 8 + 16 + 8 + dataSize);
+        file.write("WAVEfmt ", 8);
+        write32(16);
+        write16(3);
+        write16(channels);
+        write32(rate);
+        write32(rate * channels * 4);
+        write16((uint16_t) (channels * 4));
+        write16(32);
+
+        // Interleaved frames:
+        std::vector<float> frames(audio.samples.size());
+
+        for (int i = 0; i < audio.length; i++) {
+            for (int channel = 0; channel < numChannels; channel++) {
+                frames[(size_t) (i * numChannels + channel)] = audio.getChannel(channel)[i];
+            }
+        }
+
+        file.write("data", 4);
+        write32(dataSize);
+        file.write(reinterpret_cast<const char*>(frames.data()), dataSize);
+
+        return (bool) file;
+    }
+
+    // Reads a file written by writeWavFile, false for anything else:
+    bool readWavFile (const std::string& path, Audio& audio)
+    {
+        std::ifstream file(path, std::ios::binary);
+        char id[4];
+        uint32_t size = 0;
+
+        if (! file.read(id, 4) || std::memcmp(id, "RIFF", 4) != 0 || ! file.read(reinterpret_cast<char*>(&size), 4)
+            || ! file.read(id, 4) || std::memcmp(id, "WAVE", 4) != 0)
+            return false;
+
+        bool isFloatStereo = false;
+
+        // Chunks in any order, the samples are in "data":
+        while (file.read(id, 4) && file.read(reinterpret_cast<char*>(&size), 4)) {
+            if (std::memcmp(id, "fmt ", 4) == 0) {
+                std::vector<char> format(size);
+                file.read(format.data(), size);
+
+                uint16_t formatTag, channels, bits;
+                std::memcpy(&formatTag, format.data(), 2);
+                std::memcpy(&channels, format.data() + 2, 2);
+                std::memcpy(&bits, format.data() + 14, 2);
+                isFloatStereo = formatTag == 3 && channels == numChannels && bits == 32;
+            }
+            else if (std::memcmp(id, "data", 4) == 0) {
+                if (! isFloatStereo)
+                    return false;
+
+                std::vector<float> frames(size / sizeof (float));
+                file.read(reinterpret_cast<char*>(frames.data()), (std::streamsize) (frames.size() * sizeof (float)));
+
+                audio.length = (int) (frames.size() / numChannels);
+                audio.samples.assign(frames.size(), 0.0f);
+
+                for (int i = 0; i < audio.length; i++) {
+                    for (int channel = 0; channel < numChannels; channel++) {
+                        audio.getChannel(channel)[i] = frames[(size_t) (i * numChannels + channel)];
+                    }
+                }
+
+                return (bool) file;
+            }
+            else {
+                file.seekg(size + (size & 1), std::ios::cur);
+            }
+        }
+
+        return false;
+    }
+
+    //==============================================================================
+    // The reference: the signal through the plugin as it was, FROGGBaselineRender, in blocks:
+    Audio renderBaseline (const Audio& input, double sampleRate, const FROGGBaselineRender::Parameters& parameters)
+    {
+        Audio output = input;
+        FROGGBaselineRender baseline(sampleRate);
+
+        for (int blockStart = 0; blockStart < output.length; blockStart += referenceBlockSize) {
+            const int blockSize = std::min(referenceBlockSize, output.length - blockStart);
+            baseline.process(output.getChannel(0) + blockStart, output.getChannel(1) + blockStart, blockSize, parameters);
+        }
+
+        return output;
+    }
+
+    // Core parameters of a parameter set, on the legacy settings:
+    FROGGCore::Parameters getCoreParameters (const FROGGBaselineRender::Parameters& values)
+    {
+        FROGGCore::Parameters parameters;
+        parameters.dryWet = values.dryWet;
+        parameters.depth = values.depth;
+        parameters.rate = values.rate;
+        parameters.phaseOffset = values.phaseOffset;
+        parameters.feedback = values.feedback;
+        parameters.type = values.type;
+        parameters.voices = 1;
+        parameters.interpolation = (int) FROGGInterpolation::linear;
+        parameters.quality = FROGGLegacyQualityTier;
+        return parameters;
+    }
+
+    constexpr int maxRandomBlockSize = 1024;
+
+    /**
+        The signal through FROGGCore in blocks of blockSize, or of random sizes
+        up to maxRandomBlockSize when it is 0, in double precision buffers when
+        doublePrecision. The output is moved back by the latency of the core, so
+        it lines up with the input.
+    */
+    Audio renderCore (const Audio& input, double sampleRate, const FROGGCore::Parameters& parameters, int blockSize, bool doublePrecision = false)
+    {
+        FROGGCore core;
+        core.prepare(sampleRate, numChannels, blockSize > 0 ? blockSize : maxRandomBlockSize, doublePrecision, parameters);
+
+        // Silence after the input flushes out what the latency holds back:
+        const int latency = core.getLatencySamples();
+        const int length = input.length + latency;
+
+        std::vector<double> buffer((size_t) (numChannels * length), 0.0);
+        std::vector<float> floatBuffer((size_t) (numChannels * length), 0.0f);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            std::copy(input.getChannel(channel), input.getChannel(channel) + input.length, buffer.begin() + channel * length);
+            std::copy(input.getChannel(channel), input.getChannel(channel) + input.length, floatBuffer.begin() + channel * length);
+        }
+
+        Random random { 42u };
+
+        for (int blockStart = 0; blockStart < length;) {
+            const int size = std::min(length - blockStart, blockSize > 0 ? blockSize : 1 + random.nextInt(maxRandomBlockSize));
+
+            if (doublePrecision) {
+                double* channels[numChannels] = { buffer.data() + blockStart, buffer.data() + length + blockStart };
+                core.process(channels, numChannels, size);
+            }
+            else {
+                float* channels[numChannels] = { floatBuffer.data() + blockStart, floatBuffer.data() + length + blockStart };
+                core.process(channels, numChannels, size);
+            }
+
+            blockStart += size;
+        }
+
+        Audio output;
+        output.length = input.length;
+        output.samples.resize(input.samples.size());
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            for (int i = 0; i < input.length; i++) {
+                const size_t index = (size_t) (channel * length + latency + i);
+                output.getChannel(channel)[i] = doublePrecision ? (float) buffer[index] : floatBuffer[index];
+            }
+        }
+
+        return output;
+    }
+
+    /**
+        Samples chunkStart to chunkEnd of the render of input with the LFO on the
+        timeline, the way FROGGBatch renders a chunk: the core starts a tail and
+        its latency before the chunk (or at 0), synced to the timeline there, and
+        runs in blocks of random sizes from seed.
+    */
+    Audio renderChunk (const Audio& input, double sampleRate, const FROGGCore::Parameters& parameters, int chunkStart, int chunkEnd, uint32_t seed)
+    {
+        FROGGCore core;
+        core.prepare(sampleRate, numChannels, maxRandomBlockSize, false, parameters);
+
+        const int latency = core.getLatencySamples();
+        const int preroll = (int) std::ceil(FROGGCore::computeTailSeconds(parameters.feedback, parameters.type) * sampleRate) + latency;
+        const int start = std::max(0, chunkStart - preroll);
+        const int length = chunkEnd + latency - start;
+
+        // The input from the start of the preroll, silence past its end:
+        std::vector<float> buffer((size_t) (numChannels * length), 0.0f);
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            const float* samples = input.getChannel(channel);
+            std::copy(samples + start, samples + std::min(input.length, start + length), buffer.begin() + channel * length);
+        }
+
+        // Playhead sync, cycles since sample 0 of the timeline:
+        core.syncLFOToTimeline((double) start * parameters.rate / sampleRate, start);
+
+        Random random { seed };
+
+        for (int blockStart = 0; blockStart < length;) {
+            const int size = std::min(length - blockStart, 1 + random.nextInt(maxRandomBlockSize));
+            float* channels[numChannels] = { buffer.data() + blockStart, buffer.data() + length + blockStart };
+
+            core.process(channels, numChannels, size);
+            blockStart += size;
+        }
+
+        Audio output;
+        output.length = chunkEnd - chunkStart;
+        output.samples.resize((size_t) (numChannels * output.length));
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            const float* samples = buffer.data() + channel * length + chunkStart + latency - start;
+            std::copy(samples, samples + output.length, output.getChannel(channel));
+        }
+
+        return output;
+    }
+
+    //==============================================================================
+    /**
+        Passes or fails the cases and counts them. Bit exact (toleranceDb of
+        bitExact), every sample has to be identical; otherwise the largest
+        difference has to stay at or below toleranceDb (dBFS). measure() only
+        prints the difference.
+    */
+    struct TestRunner
+    {
+        std::string filter;
+        int numPassed = 0;
+        int numFailed = 0;
+        int numSkipped = 0;
+
+        bool isSelected (const std::string& name) const
+        {
+            return filter.empty() || name.find(filter) != std::string::npos;
+        }
+
+        void check (const std::string& name, const Audio& output, const Audio& expected, double toleranceDb)
+        {
+            if (output.length != expected.length) {
+                report(false, name, "length " + std::to_string(output.length) + " instead of " + std::to_string(expected.length));
+                return;
+            }
+
+            const std::string limit = toleranceDb == bitExact ? "bit exact" : formatDb(toleranceDb);
+            double errorDb;
+            const std::string difference = compare(output, expected, errorDb);
+
+            report(errorDb <= toleranceDb, name, difference + (errorDb == bitExact ? "" : ", limit " + limit));
+        }
+
+        void measure (const std::string& name, const Audio& output, const Audio& expected)
+        {
+            double errorDb;
+            std::cout << "INFO  " << name << ": " << compare(output, expected, errorDb) << std::endl;
+        }
+
+        void skip (const std::string& name, const std::string& reason)
+        {
+            numSkipped++;
+            std::cout << "SKIP  " << name << ": " << reason << std::endl;
+        }
+
+        void report (bool passed, const std::string& name, const std::string& details)
+        {
+            (passed ? numPassed : numFailed)++;
+            std::cout << (passed ? "PASS  " : "FAIL  ") << name << ": " << details << std::endl;
+        }
+
+        // Largest difference in dBFS (bitExact for none) and where the first one is:
+        static std::string compare (const Audio& output, const Audio& expected, double& errorDb)
+        {
+            float maxError = 0.0f;
+            long firstDifference = -1;
+
+            for (size_t i = 0; i < output.samples.size(); i++) {
+                if (output.samples[i] != expected.samples[i]) {
+                    // A NaN on either side never matches:
+                    const float error = std::abs(output.samples[i] - expected.samples[i]);
+                    maxError = std::isnan(error) ? std::numeric_limits<float>::infinity() : std::max(maxError, error);
+
+                    if (firstDifference < 0) {
+                        firstDifference = (long) (i % (size_t) output.length);
+                    }
+                }
+            }
+
+            if (firstDifference < 0) {
+                errorDb = bitExact;
+                return "bit exact";
+            }
+
+            errorDb = maxError > 0.0f ? 20.0 * std::log10((double) maxError) : -400.0;
+            return "max error " + formatDb(errorDb) + ", first at sample " + std::to_string(firstDifference);
+        }
+
+        static std::string formatDb (double db)
+        {
+            char text[32];
+            std::snprintf(text, sizeof (text), "%.1f dBFS", db);
+            return text;
+        }
+    };
+
+    std::string getReferenceName (const std::string& signal, const ParameterSet& set, double sampleRate)
+    {
+        return signal + "_" + set.name + "_" + std::to_string((int) sampleRate) + ".wav";
+    }
+
+    std::string getCaseName (const std::string& test, const std::string& signal, const ParameterSet& set, double sampleRate)
+    {
+        return test + " / " + set.name + " " + signal + " " + std::to_string((int) sampleRate);
+    }
+
+    //==============================================================================
+    // Renders every reference with FROGGBaselineRender into directory:
+    int writeReferences (const std::string& directory)
+    {
+        for (double sampleRate : sampleRates) {
+            for (const ParameterSet& set : parameterSets) {
+                for (const char* signal : signalNames) {
+                    const std::string path = directory + "/" + getReferenceName(signal, set, sampleRate);
+
+                    if (! writeWavFile(path, renderBaseline(makeTestSignal(signal, sampleRate), sampleRate, set.values), sampleRate)) {
+                        std::cerr << "Can't write " << path << std::endl;
+                        return 1;
+                    }
+
+                    std::cout << "Wrote " << path << std::endl;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    // Every case of one reference:
+    void runCases (TestRunner& runner, const std::string& signal, const ParameterSet& set, double sampleRate, const Audio& reference)
+    {
+        const Audio input = makeTestSignal(signal, sampleRate);
+        const FROGGCore::Parameters legacy = getCoreParameters(set.values);
+
+        // The legacy settings keep the sound of the plugin, in float and double buffers and on the double engine:
+        const Audio render = renderCore(input, sampleRate, legacy, referenceBlockSize);
+
+        if (runner.isSelected(getCaseName("legacy", signal, set, sampleRate))) {
+            runner.check(getCaseName("legacy", signal, set, sampleRate), render, reference, legacyToleranceDb);
+        }
+
+        if (runner.isSelected(getCaseName("legacy double", signal, set, sampleRate))) {
+            runner.check(getCaseName("legacy double", signal, set, sampleRate), renderCore(input, sampleRate, legacy, referenceBlockSize, true), reference, legacyToleranceDb);
+        }
+
+        if (runner.isSelected(getCaseName("Ultra", signal, set, sampleRate))) {
+            FROGGCore::Parameters parameters = legacy;
+            parameters.quality = 3;
+            runner.check(getCaseName("Ultra", signal, set, sampleRate), renderCore(input, sampleRate, parameters, referenceBlockSize), reference, legacyToleranceDb);
+        }
+
+        // The trade-offs, how far they are from the sound of the plugin:
+        FROGGCore::Parameters settings[std::size(tradeOffs) + 2];
+        std::string settingNames[std::size(tradeOffs) + 2];
+
+        for (size_t i = 0; i < std::size(tradeOffs); i++) {
+            settings[i] = legacy;
+            settings[i].quality = tradeOffs[i].quality;
+            settings[i].interpolation = tradeOffs[i].interpolation;
+            settingNames[i] = tradeOffs[i].name;
+        }
+
+        size_t numSettings = std::size(tradeOffs);
+
+        if (FROGGGetRateReduction(sampleRate) > 1) {
+            settings[numSettings] = legacy;
+            settings[numSettings].rateReduction = true;
+            settingNames[numSettings++] = "rate reduction";
+        }
+
+        for (size_t i = 0; i < numSettings; i++) {
+            if (runner.isSelected(getCaseName(settingNames[i], signal, set, sampleRate))) {
+                runner.measure(getCaseName(settingNames[i], signal, set, sampleRate), renderCore(input, sampleRate, settings[i], referenceBlockSize), reference);
+            }
+        }
+
+        // Any block size gives the same samples as blocks of referenceBlockSize (0 random sizes), on
+        // the legacy settings and every trade-off:
+        settings[numSettings] = legacy;
+        settingNames[numSettings++] = "legacy";
+
+        for (size_t i = 0; i < numSettings; i++) {
+            const Audio expected = i + 1 == numSettings ? render : renderCore(input, sampleRate, settings[i], referenceBlockSize);
+
+            for (int blockSize : { 1, 7, 64, 480, 4096, 0 }) {
+                const std::string name = getCaseName(settingNames[i] + " block " + (blockSize > 0 ? std::to_string(blockSize) : std::string("random")), signal, set, sampleRate);
+
+                if (runner.isSelected(name)) {
+                    runner.check(name, renderCore(input, sampleRate, settings[i], blockSize), expected, bitExact);
+                }
+            }
+        }
+    }
+
+    // Renders cut into chunks and joined against the whole render, on the legacy settings, with the
+    // LFO at a control rate (Eco) and with rate reduction:
+    void runChunkCases (TestRunner& runner, const std::string& signal, const ParameterSet& set, double sampleRate)
+    {
+        const Audio input = makeTestSignal(signal, sampleRate, chunkedRenderSeconds);
+        const FROGGCore::Parameters legacy = getCoreParameters(set.values);
+
+        FROGGCore::Parameters settings[3] = { legacy, legacy, legacy };
+        const std::string settingNames[3] = { "legacy", "Eco", "rate reduction" };
+        settings[1].quality = 0;
+        settings[2].rateReduction = true;
+
+        const size_t numSettings = FROGGGetRateReduction(sampleRate) > 1 ? 3 : 2;
+
+        for (size_t i = 0; i < numSettings; i++) {
+            const std::string name = getCaseName(settingNames[i] + " chunks", signal, set, sampleRate);
+
+            if (! runner.isSelected(name))
+                continue;
+
+            Audio joined;
+            joined.length = input.length;
+            joined.samples.resize(input.samples.size());
+
+            for (int chunk = 0; chunk < numChunks; chunk++) {
+                const int chunkStart = input.length * chunk / numChunks;
+                const Audio output = renderChunk(input, sampleRate, settings[i], chunkStart, input.length * (chunk + 1) / numChunks, 100u + (uint32_t) chunk);
+
+                for (int channel = 0; channel < numChannels; channel++) {
+                    std::copy(output.getChannel(channel), output.getChannel(channel) + output.length, joined.getChannel(channel) + chunkStart);
+                }
+            }
+
+            runner.check(name, joined, renderChunk(input, sampleRate, settings[i], 0, input.length, 99u), chunkToleranceDb);
+        }
+    }
+
+    // The kernels of every instruction set against the generic ones, on the legacy settings:
+    void runInstructionSetCases (TestRunner& runner, const std::string& signal, const ParameterSet& set, double sampleRate)
+    {
+        const FROGGInstructionSet best = FROGGGetKernels().instructionSet;
+        const Audio input = makeTestSignal(signal, sampleRate);
+        const FROGGCore::Parameters legacy = getCoreParameters(set.values);
+
+        FROGGForceInstructionSet(FROGGInstructionSet::generic);
+        const Audio generic = renderCore(input, sampleRate, legacy, referenceBlockSize);
+
+        struct Tested { FROGGInstructionSet instructionSet; const char* name; double toleranceDb; };
+
+        for (const Tested& tested : { Tested { FROGGInstructionSet::sse2, "sse2", bitExact },
+                                      Tested { FROGGInstructionSet::avx2, "avx2", fusedMultiplyAddToleranceDb },
+                                      Tested { FROGGInstructionSet::avx512, "avx512", fusedMultiplyAddToleranceDb },
+                                      Tested { FROGGInstructionSet::neon, "neon", fusedMultiplyAddToleranceDb } }) {
+            const std::string name = getCaseName(std::string("isa ") + tested.name, signal, set, sampleRate);
+
+            if (! runner.isSelected(name))
+                continue;
+
+            if (! FROGGForceInstructionSet(tested.instructionSet)) {
+                runner.skip(name, "not available on this build or CPU");
+                continue;
+            }
+
+            runner.check(name, renderCore(input, sampleRate, legacy, referenceBlockSize), generic, tested.toleranceDb);
+        }
+
+        FROGGForceInstructionSet(best);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    std::string referenceDirectory = "Tools/FROGGTests/References";
+    bool shouldWriteReferences = false;
+    TestRunner runner;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--references" && hasValue) {
+            referenceDirectory = argv[++i];
+        }
+        else if (argument == "--filter" && hasValue) {
+            runner.filter = argv[++i];
+        }
+        else if (argument == "--write-references") {
+            shouldWriteReferences = true;
+        }
+        else {
+            std::cout << "Usage: FROGGTests [options]" << std::endl
+                      << std::endl
+                      << "Renders test signals through FROGGCore and checks them against the reference" << std::endl
+                      << "renders of the plugin before it, and against each other. Prints PASS or FAIL per" << std::endl
+                      << "case and exits with 1 if any case failed." << std::endl
+                      << std::endl
+                      << "  --references <directory>  reference renders (default: Tools/FROGGTests/References," << std::endl
+                      << "                            run from the repository root)" << std::endl
+                      << "  --filter <text>           only the cases whose name contains text, e.g. \"legacy\"" << std::endl
+                      << "  --write-references        renders the references with the code of the plugin" << std::endl
+                      << "                            before FROGGCore (FROGGBaselineRender) instead" << std::endl;
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    if (shouldWriteReferences) {
+        return writeReferences(referenceDirectory);
+    }
+
+    for (double sampleRate : sampleRates) {
+        for (const ParameterSet& set : parameterSets) {
+            for (const char* signal : signalNames) {
+                Audio reference;
+                const std::string path = referenceDirectory + "/" + getReferenceName(signal, set, sampleRate);
+
+                if (! readWavFile(path, reference)) {
+                    runner.report(false, getCaseName("reference", signal, set, sampleRate), "can't read " + path);
+                    continue;
+                }
+
+                runCases(runner, signal, set, sampleRate, reference);
+                runInstructionSetCases(runner, signal, set, sampleRate);
+                runChunkCases(runner, signal, set, sampleRate);
+            }
+        }
+    }
+
+    std::cout << std::endl << runner.numPassed << " passed, " << runner.numFailed << " failed, " << runner.numSkipped << " skipped" << std::endl;
+    return runner.numFailed > 0 ? 1 : 0;
+}